@@ -0,0 +1,131 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <glib.h>
+#include "arena.h"
+
+/* The alignment of all the allocations - enough for pointers and doubles */
+#define P2T_ARENA_ALIGN(size) (((size) + G_MEM_ALIGN - 1) & ~((gsize) G_MEM_ALIGN - 1))
+
+struct _P2tArenaBlock
+{
+  P2tArenaBlock *next;
+  gsize          size;
+};
+
+#define P2T_ARENA_BLOCK_HEADER P2T_ARENA_ALIGN (sizeof (P2tArenaBlock))
+
+void
+p2t_arena_init (P2tArena *THIS, gsize block_size)
+{
+  THIS->blocks = NULL;
+  THIS->spare = NULL;
+  THIS->next = NULL;
+  THIS->remaining = 0;
+  THIS->block_size = P2T_ARENA_ALIGN (block_size);
+}
+
+static void
+p2t_arena_free_blocks (P2tArenaBlock *block)
+{
+  while (block != NULL)
+    {
+      P2tArenaBlock *next = block->next;
+      g_free (block);
+      block = next;
+    }
+}
+
+void
+p2t_arena_destroy (P2tArena *THIS)
+{
+  p2t_arena_free_blocks (THIS->blocks);
+  p2t_arena_free_blocks (THIS->spare);
+
+  p2t_arena_init (THIS, THIS->block_size);
+}
+
+void
+p2t_arena_reset (P2tArena *THIS)
+{
+  /* Move the used blocks to the spare list. Reversing them puts the
+   * oldest block first, so the blocks are used again in the same order */
+  while (THIS->blocks != NULL)
+    {
+      P2tArenaBlock *block = THIS->blocks;
+      THIS->blocks = block->next;
+      block->next = THIS->spare;
+      THIS->spare = block;
+    }
+
+  THIS->next = NULL;
+  THIS->remaining = 0;
+}
+
+gpointer
+p2t_arena_alloc (P2tArena *THIS, gsize size)
+{
+  gchar *result;
+
+  size = P2T_ARENA_ALIGN (size);
+
+  if (G_UNLIKELY (size > THIS->remaining))
+    {
+      gsize block_size = MAX (size, THIS->block_size);
+      P2tArenaBlock *block;
+
+      if (THIS->spare != NULL && THIS->spare->size >= size)
+        {
+          block = THIS->spare;
+          THIS->spare = block->next;
+        }
+      else
+        {
+          block = (P2tArenaBlock*) g_malloc (P2T_ARENA_BLOCK_HEADER + block_size);
+          block->size = block_size;
+        }
+
+      block->next = THIS->blocks;
+      THIS->blocks = block;
+
+      THIS->next = (gchar*) block + P2T_ARENA_BLOCK_HEADER;
+      THIS->remaining = block->size;
+    }
+
+  result = THIS->next;
+  THIS->next += size;
+  THIS->remaining -= size;
+  return result;
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __P2TC_P2T_ARENA_H__
+#define __P2TC_P2T_ARENA_H__
+
+#include <glib.h>
+#include "poly2tri-private.h"
+
+#ifdef	__cplusplus
+extern "C"
+{
+#endif
+
+typedef struct _P2tArenaBlock P2tArenaBlock;
+
+/**
+ * P2tArena:
+ * @blocks: The list of memory blocks owned by the arena, newest first
+ * @spare: Blocks kept by #p2t_arena_reset, to be used again before
+ *         allocating new ones
+ * @next: The first free byte in the newest block
+ * @remaining: The amount of free bytes left after @next
+ * @block_size: The default size of a new block
+ *
+ * A bump allocator for objects that share a single lifetime. Allocating
+ * only advances a pointer inside the current block, and all the objects
+ * are released together when the arena is destroyed or reset - there is
+ * no way to free a single object.
+ */
+struct _P2tArena
+{
+  /*< private >*/
+  P2tArenaBlock *blocks;
+  P2tArenaBlock *spare;
+  gchar         *next;
+  gsize          remaining;
+  gsize          block_size;
+};
+
+void     p2t_arena_init    (P2tArena *THIS, gsize block_size);
+
+void     p2t_arena_destroy (P2tArena *THIS);
+
+/**
+ * p2t_arena_reset:
+ * @THIS: The arena to reset
+ *
+ * Release all the objects allocated from the arena at once, but keep its
+ * memory blocks for the following allocations.
+ */
+void     p2t_arena_reset   (P2tArena *THIS);
+
+/**
+ * p2t_arena_alloc:
+ * @THIS: The arena to allocate from
+ * @size: The amount of bytes to allocate
+ *
+ * Returns: A block of @size bytes, aligned for any of the basic types. The
+ *          memory is not cleared, and remains valid until the arena is
+ *          destroyed or reset
+ */
+gpointer p2t_arena_alloc   (P2tArena *THIS, gsize size);
+
+#define p2t_arena_new(arena,type) ((type*) p2t_arena_alloc ((arena), sizeof (type)))
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif
@@ -41,17 +41,27 @@ extern "C"
 {
 #endif
 
+typedef struct _P2tArena P2tArena;
+typedef struct _P2tBatch P2tBatch;
+typedef struct _P2tBatchPolygon P2tBatchPolygon;
+typedef struct _P2tBatchWorker P2tBatchWorker;
 typedef struct _P2tNode P2tNode;
 typedef struct AdvancingFront_ P2tAdvancingFront;
 typedef struct CDT_ P2tCDT;
 typedef struct _P2tEdge P2tEdge;
+typedef struct _P2tInsert P2tInsert;
+typedef struct _P2tMonotone P2tMonotone;
 typedef struct _P2tPoint P2tPoint;
+typedef struct _P2tPslg P2tPslg;
+typedef struct _P2tSanitizer P2tSanitizer;
+typedef struct _P2tSlabs P2tSlabs;
 typedef struct _P2tTriangle P2tTriangle;
 typedef struct SweepContext_ P2tSweepContext;
 typedef struct Sweep_ P2tSweep;
 
 typedef struct P2tSweepContextBasin_ P2tSweepContextBasin;
 typedef struct P2tSweepContextEdgeEvent_ P2tSweepContextEdgeEvent;
+typedef struct P2tSweepContextRing_ P2tSweepContextRing;
 
 
 #ifdef	__cplusplus
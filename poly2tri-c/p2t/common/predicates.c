@@ -0,0 +1,372 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <math.h>
+#include <glib.h>
+#include "predicates.h"
+
+/* 2^-53, the relative rounding error of double precision arithmetic */
+#define P2T_PRED_EPSILON     1.1102230246251565e-16
+/* 2^27 + 1, used to split a double into two non-overlapping halves */
+#define P2T_PRED_SPLITTER    134217729.0
+
+#define P2T_PRED_CCW_ERRBOUND ((3.0 + 16.0 * P2T_PRED_EPSILON) * P2T_PRED_EPSILON)
+#define P2T_PRED_ICC_ERRBOUND ((10.0 + 96.0 * P2T_PRED_EPSILON) * P2T_PRED_EPSILON)
+
+/* The error-free transformations below compute x + y such that x is the
+ * rounded result and y is the exact rounding error. They use the local
+ * variables bvirt, avirt, bround, around, c, abig, ahi, alo, bhi, blo,
+ * err1, err2 and err3 */
+
+#define Fast_Two_Sum(a, b, x, y) \
+  x = (double) (a + b); \
+  bvirt = x - a; \
+  y = b - bvirt
+
+#define Two_Sum(a, b, x, y) \
+  x = (double) (a + b); \
+  bvirt = (double) (x - a); \
+  avirt = x - bvirt; \
+  bround = b - bvirt; \
+  around = a - avirt; \
+  y = around + bround
+
+#define Two_Diff(a, b, x, y) \
+  x = (double) (a - b); \
+  bvirt = (double) (a - x); \
+  avirt = x + bvirt; \
+  bround = bvirt - b; \
+  around = a - avirt; \
+  y = around + bround
+
+#define Split(a, ahi, alo) \
+  c = (double) (P2T_PRED_SPLITTER * a); \
+  abig = (double) (c - a); \
+  ahi = c - abig; \
+  alo = a - ahi
+
+#define Two_Product(a, b, x, y) \
+  x = (double) (a * b); \
+  Split (a, ahi, alo); \
+  Split (b, bhi, blo); \
+  err1 = x - (ahi * bhi); \
+  err2 = err1 - (alo * bhi); \
+  err3 = err2 - (ahi * blo); \
+  y = (alo * blo) - err3
+
+#define Two_Product_Presplit(a, b, bhi, blo, x, y) \
+  x = (double) (a * b); \
+  Split (a, ahi, alo); \
+  err1 = x - (ahi * bhi); \
+  err2 = err1 - (alo * bhi); \
+  err3 = err2 - (ahi * blo); \
+  y = (alo * blo) - err3
+
+#define Two_One_Diff(a1, a0, b, x2, x1, x0) \
+  Two_Diff (a0, b, _i, x0); \
+  Two_Sum (a1, _i, x2, x1)
+
+#define Two_Two_Diff(a1, a0, b1, b0, x3, x2, x1, x0) \
+  Two_One_Diff (a1, a0, b0, _j, _0, x0); \
+  Two_One_Diff (_j, _0, b1, x3, x2, x1)
+
+/* Sum two expansions, eliminating zero components from the result. h must
+ * have room for elen + flen components */
+static int
+p2t_pred_expansion_sum (int elen, const double *e, int flen, const double *f, double *h)
+{
+  double Q, Qnew, hh;
+  double bvirt, avirt, bround, around;
+  int eindex = 0, findex = 0, hindex = 0;
+  double enow = e[0];
+  double fnow = f[0];
+
+  if ((fnow > enow) == (fnow > -enow))
+    {
+      Q = enow;
+      enow = (++eindex < elen) ? e[eindex] : 0;
+    }
+  else
+    {
+      Q = fnow;
+      fnow = (++findex < flen) ? f[findex] : 0;
+    }
+
+  if ((eindex < elen) && (findex < flen))
+    {
+      if ((fnow > enow) == (fnow > -enow))
+        {
+          Fast_Two_Sum (enow, Q, Qnew, hh);
+          enow = (++eindex < elen) ? e[eindex] : 0;
+        }
+      else
+        {
+          Fast_Two_Sum (fnow, Q, Qnew, hh);
+          fnow = (++findex < flen) ? f[findex] : 0;
+        }
+      Q = Qnew;
+      if (hh != 0.0)
+        h[hindex++] = hh;
+
+      while ((eindex < elen) && (findex < flen))
+        {
+          if ((fnow > enow) == (fnow > -enow))
+            {
+              Two_Sum (Q, enow, Qnew, hh);
+              enow = (++eindex < elen) ? e[eindex] : 0;
+            }
+          else
+            {
+              Two_Sum (Q, fnow, Qnew, hh);
+              fnow = (++findex < flen) ? f[findex] : 0;
+            }
+          Q = Qnew;
+          if (hh != 0.0)
+            h[hindex++] = hh;
+        }
+    }
+
+  while (eindex < elen)
+    {
+      Two_Sum (Q, enow, Qnew, hh);
+      enow = (++eindex < elen) ? e[eindex] : 0;
+      Q = Qnew;
+      if (hh != 0.0)
+        h[hindex++] = hh;
+    }
+
+  while (findex < flen)
+    {
+      Two_Sum (Q, fnow, Qnew, hh);
+      fnow = (++findex < flen) ? f[findex] : 0;
+      Q = Qnew;
+      if (hh != 0.0)
+        h[hindex++] = hh;
+    }
+
+  if ((Q != 0.0) || (hindex == 0))
+    h[hindex++] = Q;
+  return hindex;
+}
+
+/* Multiply an expansion by a double, eliminating zero components from the
+ * result. h must have room for 2 * elen components */
+static int
+p2t_pred_scale_expansion (int elen, const double *e, double b, double *h)
+{
+  double Q, sum, hh, product1, product0, enow;
+  double bvirt, avirt, bround, around;
+  double c, abig, ahi, alo, bhi, blo;
+  double err1, err2, err3;
+  int eindex, hindex = 0;
+
+  Split (b, bhi, blo);
+  Two_Product_Presplit (e[0], b, bhi, blo, Q, hh);
+  if (hh != 0)
+    h[hindex++] = hh;
+
+  for (eindex = 1; eindex < elen; eindex++)
+    {
+      enow = e[eindex];
+      Two_Product_Presplit (enow, b, bhi, blo, product1, product0);
+      Two_Sum (Q, product0, sum, hh);
+      if (hh != 0)
+        h[hindex++] = hh;
+      Fast_Two_Sum (product1, sum, Q, hh);
+      if (hh != 0)
+        h[hindex++] = hh;
+    }
+
+  if ((Q != 0.0) || (hindex == 0))
+    h[hindex++] = Q;
+  return hindex;
+}
+
+/* Compute a * b - c * d exactly, as a 4 component expansion */
+#define P2T_PRED_CROSS(a, b, c, d, r) \
+  Two_Product (a, b, p1, p0); \
+  Two_Product (c, d, q1, q0); \
+  Two_Two_Diff (p1, p0, q1, q0, r[3], r[2], r[1], r[0])
+
+static double
+p2t_pred_orient2d_exact (double ax, double ay, double bx, double by, double cx, double cy)
+{
+  double bvirt, avirt, bround, around;
+  double c, abig, ahi, alo, bhi, blo;
+  double err1, err2, err3;
+  double _i, _j, _0;
+  double p1, p0, q1, q0;
+  double aterms[4], bterms[4], cterms[4], v[8], w[12];
+  int vlength, wlength;
+
+  P2T_PRED_CROSS (ax, by, ax, cy, aterms);
+  P2T_PRED_CROSS (bx, cy, bx, ay, bterms);
+  P2T_PRED_CROSS (cx, ay, cx, by, cterms);
+
+  vlength = p2t_pred_expansion_sum (4, aterms, 4, bterms, v);
+  wlength = p2t_pred_expansion_sum (vlength, v, 4, cterms, w);
+
+  return w[wlength - 1];
+}
+
+/* Add the lifted term s * (px^2 + py^2) to an expansion, where s is an
+ * expansion of length slen. The result is stored in det (up to 96
+ * components) and its length is returned */
+static int
+p2t_pred_lift (int slen, const double *s, double px, double py, double sign, double *det)
+{
+  double det24x[24], det24y[24], det48x[48], det48y[48];
+  int xlen, ylen;
+
+  xlen = p2t_pred_scale_expansion (slen, s, px, det24x);
+  xlen = p2t_pred_scale_expansion (xlen, det24x, sign * px, det48x);
+  ylen = p2t_pred_scale_expansion (slen, s, py, det24y);
+  ylen = p2t_pred_scale_expansion (ylen, det24y, sign * py, det48y);
+  return p2t_pred_expansion_sum (xlen, det48x, ylen, det48y, det);
+}
+
+static double
+p2t_pred_incircle_exact (double ax, double ay, double bx, double by,
+                         double cx, double cy, double dx, double dy)
+{
+  double bvirt, avirt, bround, around;
+  double c, abig, ahi, alo, bhi, blo;
+  double err1, err2, err3;
+  double _i, _j, _0;
+  double p1, p0, q1, q0;
+  double ab[4], bc[4], cd[4], da[4], ac[4], bd[4];
+  double temp8[8];
+  double abc[12], bcd[12], cda[12], dab[12];
+  double adet[96], bdet[96], cdet[96], ddet[96];
+  double abdet[192], cddet[192], deter[384];
+  int templen, abclen, bcdlen, cdalen, dablen;
+  int alen, blen, clen, dlen, ablen, cdlen, deterlen;
+  int i;
+
+  P2T_PRED_CROSS (ax, by, bx, ay, ab);
+  P2T_PRED_CROSS (bx, cy, cx, by, bc);
+  P2T_PRED_CROSS (cx, dy, dx, cy, cd);
+  P2T_PRED_CROSS (dx, ay, ax, dy, da);
+  P2T_PRED_CROSS (ax, cy, cx, ay, ac);
+  P2T_PRED_CROSS (bx, dy, dx, by, bd);
+
+  templen = p2t_pred_expansion_sum (4, cd, 4, da, temp8);
+  cdalen = p2t_pred_expansion_sum (templen, temp8, 4, ac, cda);
+  templen = p2t_pred_expansion_sum (4, da, 4, ab, temp8);
+  dablen = p2t_pred_expansion_sum (templen, temp8, 4, bd, dab);
+  for (i = 0; i < 4; i++)
+    {
+      bd[i] = -bd[i];
+      ac[i] = -ac[i];
+    }
+  templen = p2t_pred_expansion_sum (4, ab, 4, bc, temp8);
+  abclen = p2t_pred_expansion_sum (templen, temp8, 4, ac, abc);
+  templen = p2t_pred_expansion_sum (4, bc, 4, cd, temp8);
+  bcdlen = p2t_pred_expansion_sum (templen, temp8, 4, bd, bcd);
+
+  alen = p2t_pred_lift (bcdlen, bcd, ax, ay, +1, adet);
+  blen = p2t_pred_lift (cdalen, cda, bx, by, -1, bdet);
+  clen = p2t_pred_lift (dablen, dab, cx, cy, +1, cdet);
+  dlen = p2t_pred_lift (abclen, abc, dx, dy, -1, ddet);
+
+  ablen = p2t_pred_expansion_sum (alen, adet, blen, bdet, abdet);
+  cdlen = p2t_pred_expansion_sum (clen, cdet, dlen, ddet, cddet);
+  deterlen = p2t_pred_expansion_sum (ablen, abdet, cdlen, cddet, deter);
+
+  return deter[deterlen - 1];
+}
+
+double
+p2t_predicates_orient2d (double ax, double ay,
+                         double bx, double by,
+                         double cx, double cy)
+{
+  double detleft = (ax - cx) * (by - cy);
+  double detright = (ay - cy) * (bx - cx);
+  double det = detleft - detright;
+  double detsum;
+
+  if (detleft > 0.0)
+    {
+      if (detright <= 0.0)
+        return det;
+      detsum = detleft + detright;
+    }
+  else if (detleft < 0.0)
+    {
+      if (detright >= 0.0)
+        return det;
+      detsum = -detleft - detright;
+    }
+  else
+    return det;
+
+  if (fabs (det) >= P2T_PRED_CCW_ERRBOUND * detsum)
+    return det;
+
+  return p2t_pred_orient2d_exact (ax, ay, bx, by, cx, cy);
+}
+
+double
+p2t_predicates_incircle (double ax, double ay,
+                         double bx, double by,
+                         double cx, double cy,
+                         double dx, double dy)
+{
+  double adx = ax - dx, ady = ay - dy;
+  double bdx = bx - dx, bdy = by - dy;
+  double cdx = cx - dx, cdy = cy - dy;
+
+  double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+  double cdxady = cdx * ady, adxcdy = adx * cdy;
+  double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+  double alift = adx * adx + ady * ady;
+  double blift = bdx * bdx + bdy * bdy;
+  double clift = cdx * cdx + cdy * cdy;
+
+  double det = alift * (bdxcdy - cdxbdy)
+      + blift * (cdxady - adxcdy)
+      + clift * (adxbdy - bdxady);
+
+  double permanent = (fabs (bdxcdy) + fabs (cdxbdy)) * alift
+      + (fabs (cdxady) + fabs (adxcdy)) * blift
+      + (fabs (adxbdy) + fabs (bdxady)) * clift;
+
+  if (fabs (det) > P2T_PRED_ICC_ERRBOUND * permanent)
+    return det;
+
+  return p2t_pred_incircle_exact (ax, ay, bx, by, cx, cy, dx, dy);
+}
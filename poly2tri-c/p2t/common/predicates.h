@@ -0,0 +1,79 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __P2TC_P2T_PREDICATES_H__
+#define __P2TC_P2T_PREDICATES_H__
+
+#include <glib.h>
+
+/*
+ * Robust geometric predicates, based on the work of Jonathan Richard
+ * Shewchuk - "Adaptive Precision Floating-Point Arithmetic and Fast Robust
+ * Geometric Predicates". Each predicate first evaluates its determinant in
+ * plain double precision together with a bound on the rounding error. Only
+ * when the sign can not be trusted, the determinant is evaluated again
+ * exactly, using floating-point expansions.
+ *
+ * The returned values always have the correct sign, but their magnitude is
+ * only an approximation. These require IEEE 754 double precision arithmetic
+ * with round-to-nearest, and no extended precision registers.
+ */
+
+/**
+ * p2t_predicates_orient2d:
+ *
+ * Returns: A positive value if the points A, B and C are in counterclockwise
+ *          order, a negative value if they are in clockwise order, and zero
+ *          if they are collinear. The value is roughly twice the signed area
+ *          of the triangle ABC
+ */
+double p2t_predicates_orient2d (double ax, double ay,
+                                double bx, double by,
+                                double cx, double cy);
+
+/**
+ * p2t_predicates_incircle:
+ *
+ * Returns: A positive value if the point D lies inside the circle passing
+ *          through A, B and C, a negative value if it lies outside, and zero
+ *          if the four points are cocircular. A, B and C must be in
+ *          counterclockwise order, or the sign of the result is reversed
+ */
+double p2t_predicates_incircle (double ax, double ay,
+                                double bx, double by,
+                                double cx, double cy,
+                                double dx, double dy);
+
+#endif
@@ -44,7 +44,7 @@ p2t_point_init (P2tPoint* THIS)
 {
   THIS->x = 0;
   THIS->y = 0;
-  THIS->edge_list = g_ptr_array_new ();
+  THIS->index_ = G_MAXUINT;
 }
 
 P2tPoint*
@@ -62,7 +62,7 @@ p2t_point_init_dd (P2tPoint* THIS, double x, double y)
 {
   THIS->x = x;
   THIS->y = y;
-  THIS->edge_list = g_ptr_array_new ();
+  THIS->index_ = G_MAXUINT;
 }
 
 P2tPoint*
@@ -76,7 +76,6 @@ p2t_point_new_dd (double x, double y)
 void
 p2t_point_destroy (P2tPoint* THIS)
 {
-  g_ptr_array_free (THIS->edge_list, TRUE);
 }
 
 void
@@ -111,8 +110,6 @@ p2t_edge_init (P2tEdge* THIS, P2tPoint* p1, P2tPoint* p2)
           assert (FALSE);
         }
     }
-
-  g_ptr_array_add (THIS->q->edge_list, THIS);
 }
 
 P2tEdge*
@@ -150,10 +147,9 @@ p2t_triangle_init (P2tTriangle* THIS, P2tPoint* a, P2tPoint* b, P2tPoint* c)
   THIS->neighbors_[0] = NULL;
   THIS->neighbors_[1] = NULL;
   THIS->neighbors_[2] = NULL;
-  THIS->constrained_edge[0] = THIS->constrained_edge[1] = THIS->constrained_edge[2] = FALSE;
-  THIS->delaunay_edge[0] = THIS->delaunay_edge[1] = THIS->delaunay_edge[2] = FALSE;
-  THIS->interior_ = FALSE;
-
+  THIS->map_index_ = G_MAXUINT;
+  THIS->result_index_ = G_MAXUINT;
+  THIS->flags_ = 0;
 }
 /* Update neighbor pointers */
 
@@ -240,7 +236,7 @@ p2t_triangle_clear_neighbors (P2tTriangle* THIS)
 void
 p2t_triangle_clear_delunay_edges (P2tTriangle* THIS)
 {
-  THIS->delaunay_edge[0] = THIS->delaunay_edge[1] = THIS->delaunay_edge[2] = FALSE;
+  THIS->flags_ &= (guint8) ~P2T_TRIANGLE_DELAUNAY_EDGES;
 }
 
 P2tPoint*
@@ -356,7 +352,7 @@ p2t_triangle_edge_index (P2tTriangle* THIS, const P2tPoint* p1, const P2tPoint*
 void
 p2t_triangle_mark_constrained_edge_i (P2tTriangle* THIS, const int index)
 {
-  THIS->constrained_edge[index] = TRUE;
+  p2t_triangle_set_constrained_edge (THIS, index, TRUE);
 }
 
 void
@@ -372,15 +368,15 @@ p2t_triangle_mark_constrained_edge_pt_pt (P2tTriangle* THIS, P2tPoint* p, P2tPoi
 {
   if ((q == THIS->points_[0] && p == THIS->points_[1]) || (q == THIS->points_[1] && p == THIS->points_[0]))
     {
-      THIS->constrained_edge[2] = TRUE;
+      p2t_triangle_set_constrained_edge (THIS, 2, TRUE);
     }
   else if ((q == THIS->points_[0] && p == THIS->points_[2]) || (q == THIS->points_[2] && p == THIS->points_[0]))
     {
-      THIS->constrained_edge[1] = TRUE;
+      p2t_triangle_set_constrained_edge (THIS, 1, TRUE);
     }
   else if ((q == THIS->points_[1] && p == THIS->points_[2]) || (q == THIS->points_[2] && p == THIS->points_[1]))
     {
-      THIS->constrained_edge[0] = TRUE;
+      p2t_triangle_set_constrained_edge (THIS, 0, TRUE);
     }
 }
 
@@ -466,13 +462,13 @@ p2t_triangle_get_constrained_edge_ccw (P2tTriangle* THIS, P2tPoint* p)
 {
   if (p == THIS->points_[0])
     {
-      return THIS->constrained_edge[2];
+      return p2t_triangle_get_constrained_edge (THIS, 2);
     }
   else if (p == THIS->points_[1])
     {
-      return THIS->constrained_edge[0];
+      return p2t_triangle_get_constrained_edge (THIS, 0);
     }
-  return THIS->constrained_edge[1];
+  return p2t_triangle_get_constrained_edge (THIS, 1);
 }
 
 gboolean
@@ -480,13 +476,13 @@ p2t_triangle_get_constrained_edge_cw (P2tTriangle* THIS, P2tPoint* p)
 {
   if (p == THIS->points_[0])
     {
-      return THIS->constrained_edge[1];
+      return p2t_triangle_get_constrained_edge (THIS, 1);
     }
   else if (p == THIS->points_[1])
     {
-      return THIS->constrained_edge[2];
+      return p2t_triangle_get_constrained_edge (THIS, 2);
     }
-  return THIS->constrained_edge[0];
+  return p2t_triangle_get_constrained_edge (THIS, 0);
 }
 
 void
@@ -494,15 +490,15 @@ p2t_triangle_set_constrained_edge_ccw (P2tTriangle* THIS, P2tPoint* p, gboolean
 {
   if (p == THIS->points_[0])
     {
-      THIS->constrained_edge[2] = ce;
+      p2t_triangle_set_constrained_edge (THIS, 2, ce);
     }
   else if (p == THIS->points_[1])
     {
-      THIS->constrained_edge[0] = ce;
+      p2t_triangle_set_constrained_edge (THIS, 0, ce);
     }
   else
     {
-      THIS->constrained_edge[1] = ce;
+      p2t_triangle_set_constrained_edge (THIS, 1, ce);
     }
 }
 
@@ -511,15 +507,15 @@ p2t_triangle_set_constrained_edge_cw (P2tTriangle* THIS, P2tPoint* p, gboolean c
 {
   if (p == THIS->points_[0])
     {
-      THIS->constrained_edge[1] = ce;
+      p2t_triangle_set_constrained_edge (THIS, 1, ce);
     }
   else if (p == THIS->points_[1])
     {
-      THIS->constrained_edge[2] = ce;
+      p2t_triangle_set_constrained_edge (THIS, 2, ce);
     }
   else
     {
-      THIS->constrained_edge[0] = ce;
+      p2t_triangle_set_constrained_edge (THIS, 0, ce);
     }
 }
 
@@ -528,13 +524,13 @@ p2t_triangle_get_delunay_edge_ccw (P2tTriangle* THIS, P2tPoint* p)
 {
   if (p == THIS->points_[0])
     {
-      return THIS->delaunay_edge[2];
+      return p2t_triangle_get_delaunay_edge (THIS, 2);
     }
   else if (p == THIS->points_[1])
     {
-      return THIS->delaunay_edge[0];
+      return p2t_triangle_get_delaunay_edge (THIS, 0);
     }
-  return THIS->delaunay_edge[1];
+  return p2t_triangle_get_delaunay_edge (THIS, 1);
 }
 
 gboolean
@@ -542,13 +538,13 @@ p2t_triangle_get_delunay_edge_cw (P2tTriangle* THIS, P2tPoint* p)
 {
   if (p == THIS->points_[0])
     {
-      return THIS->delaunay_edge[1];
+      return p2t_triangle_get_delaunay_edge (THIS, 1);
     }
   else if (p == THIS->points_[1])
     {
-      return THIS->delaunay_edge[2];
+      return p2t_triangle_get_delaunay_edge (THIS, 2);
     }
-  return THIS->delaunay_edge[0];
+  return p2t_triangle_get_delaunay_edge (THIS, 0);
 }
 
 void
@@ -556,15 +552,15 @@ p2t_triangle_set_delunay_edge_ccw (P2tTriangle* THIS, P2tPoint* p, gboolean e)
 {
   if (p == THIS->points_[0])
     {
-      THIS->delaunay_edge[2] = e;
+      p2t_triangle_set_delaunay_edge (THIS, 2, e);
     }
   else if (p == THIS->points_[1])
     {
-      THIS->delaunay_edge[0] = e;
+      p2t_triangle_set_delaunay_edge (THIS, 0, e);
     }
   else
     {
-      THIS->delaunay_edge[1] = e;
+      p2t_triangle_set_delaunay_edge (THIS, 1, e);
     }
 }
 
@@ -573,15 +569,15 @@ p2t_triangle_set_delunay_edge_cw (P2tTriangle* THIS, P2tPoint* p, gboolean e)
 {
   if (p == THIS->points_[0])
     {
-      THIS->delaunay_edge[1] = e;
+      p2t_triangle_set_delaunay_edge (THIS, 1, e);
     }
   else if (p == THIS->points_[1])
     {
-      THIS->delaunay_edge[2] = e;
+      p2t_triangle_set_delaunay_edge (THIS, 2, e);
     }
   else
     {
-      THIS->delaunay_edge[0] = e;
+      p2t_triangle_set_delaunay_edge (THIS, 0, e);
     }
 }
 
@@ -674,11 +670,11 @@ p2t_triangle_contains_pt_pt (P2tTriangle* THIS, P2tPoint* p, P2tPoint* q)
 gboolean
 p2t_triangle_is_interior (P2tTriangle* THIS)
 {
-  return THIS->interior_;
+  return (THIS->flags_ & P2T_TRIANGLE_INTERIOR) != 0;
 }
 
 void
 p2t_triangle_is_interior_b (P2tTriangle* THIS, gboolean b)
 {
-  THIS->interior_ = b;
+  p2t_triangle_set_flag (THIS, P2T_TRIANGLE_INTERIOR, b);
 }
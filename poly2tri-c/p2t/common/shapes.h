@@ -46,16 +46,19 @@
  * P2tPoint:
  * @x: The x coordinate of the point
  * @y: The y coordinate of the point
- * @edge_list: The edges this point constitutes an upper ending point
+ * @index_: The position of the point in the input of the sweep context it
+ *          was added to
  *
- * A struct to represent 2D points with double precision, and to keep track
- * of the edges this point constitutes an upper ending point
+ * A struct to represent 2D points with double precision. The edges this
+ * point constitutes an upper ending point are kept by the sweep context,
+ * under @index_
  */
 struct _P2tPoint
 {
   /*< public >*/
-  P2tEdgePtrArray edge_list;
   double x, y;
+  /*< private >*/
+  guint index_;
 };
 
 /**
@@ -182,27 +185,53 @@ void p2t_edge_free (P2tEdge* THIS);
 
 /**
  * P2tTriangle:
- * @constrained_edge: Flags to determine if an edge is a Constrained edge
- * @delaunay_edg: Flags to determine if an edge is a Delauney edge
  * @points_: Triangle points
  * @neighbors_: Neighbor list
- * @interior_: Has this triangle been marked as an interior triangle?
+ * @map_index_: The slot of this triangle in the triangle map of the
+ *              #P2tSweepContext that created it
+ * @result_index_: The slot of this triangle in the triangles of the result
+ *                 of that context, or G_MAXUINT if it is not in the result
+ * @flags_: Which edges are constrained edges (bits 0-2), which edges are
+ *          Delaunay edges (bits 3-5) and whether the triangle has been marked
+ *          as an interior triangle (bit 6). Use the accessors below
  *
  * A data structure for representing a triangle, while keeping information about
  * neighbor triangles, etc.
+ *
+ * Triangles are the dominant allocation of the sweep, so the flags are packed
+ * into one byte after the pointers - on 64 bit systems a triangle takes 64
+ * bytes and fits in one cache line.
  */
 struct _P2tTriangle
 {
-  /*< public >*/
-  gboolean constrained_edge[3];
-  gboolean delaunay_edge[3];
-
   /*< private >*/
   P2tPoint * points_[3];
   struct _P2tTriangle * neighbors_[3];
-  gboolean interior_;
+  guint map_index_;
+  guint result_index_;
+  guint8 flags_;
 };
 
+#define P2T_TRIANGLE_CONSTRAINED_EDGE(index) ((guint8) (1 << (index)))
+#define P2T_TRIANGLE_DELAUNAY_EDGE(index)    ((guint8) (1 << (3 + (index))))
+#define P2T_TRIANGLE_DELAUNAY_EDGES          ((guint8) (7 << 3))
+#define P2T_TRIANGLE_INTERIOR                ((guint8) (1 << 6))
+
+#define p2t_triangle_set_flag(THIS, flag, b) \
+  ((THIS)->flags_ = (b) ? ((THIS)->flags_ | (flag)) : ((THIS)->flags_ & (guint8) ~(flag)))
+
+/** Is the edge opposite to the point with the given index constrained? */
+#define p2t_triangle_get_constrained_edge(THIS, index) \
+  (((THIS)->flags_ & P2T_TRIANGLE_CONSTRAINED_EDGE (index)) != 0)
+#define p2t_triangle_set_constrained_edge(THIS, index, b) \
+  p2t_triangle_set_flag (THIS, P2T_TRIANGLE_CONSTRAINED_EDGE (index), b)
+
+/** Is the edge opposite to the point with the given index a Delaunay edge? */
+#define p2t_triangle_get_delaunay_edge(THIS, index) \
+  (((THIS)->flags_ & P2T_TRIANGLE_DELAUNAY_EDGE (index)) != 0)
+#define p2t_triangle_set_delaunay_edge(THIS, index, b) \
+  p2t_triangle_set_flag (THIS, P2T_TRIANGLE_DELAUNAY_EDGE (index), b)
+
 P2tTriangle* p2t_triangle_new (P2tPoint* a, P2tPoint* b, P2tPoint* c);
 void p2t_triangle_init (P2tTriangle* THIS, P2tPoint* a, P2tPoint* b, P2tPoint* c);
 P2tPoint* p2t_triangle_get_point (P2tTriangle* THIS, const int index);
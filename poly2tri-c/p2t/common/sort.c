@@ -0,0 +1,250 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <glib.h>
+#include "shapes.h"
+#include "sort.h"
+
+typedef struct
+{
+  guint64   key;
+  P2tPoint *point;
+} P2tSortItem;
+
+typedef struct
+{
+  P2tSortItem *items;
+  P2tSortItem *tmp;
+  guint        n;
+} P2tSortRun;
+
+/* Map a double into an unsigned integer with the same ordering. Positive
+ * numbers only need the sign bit flipped, while for negative numbers all
+ * the bits are flipped so that larger magnitudes come first */
+static guint64
+p2t_sort_key (double value)
+{
+  union { double d; guint64 u; } bits;
+
+  /* -0.0 and 0.0 must get the same key, like in p2t_point_cmp */
+  bits.d = (value == 0) ? 0.0 : value;
+
+  if (bits.u & G_GUINT64_CONSTANT (0x8000000000000000))
+    return ~bits.u;
+  else
+    return bits.u | G_GUINT64_CONSTANT (0x8000000000000000);
+}
+
+/* A stable LSD radix sort by the keys, one byte at a time. Bytes which are
+ * the same in all the keys are skipped. Returns the buffer which holds the
+ * result - either @items or @tmp */
+static P2tSortItem*
+p2t_sort_radix (P2tSortItem *items, P2tSortItem *tmp, guint n)
+{
+  guint count[8][256];
+  guint i, pass;
+
+  memset (count, 0, sizeof (count));
+
+  for (i = 0; i < n; i++)
+    for (pass = 0; pass < 8; pass++)
+      count[pass][(items[i].key >> (8 * pass)) & 0xff]++;
+
+  for (pass = 0; pass < 8; pass++)
+    {
+      guint *c = count[pass];
+      guint b, sum = 0;
+      P2tSortItem *swap;
+
+      if (c[(items[0].key >> (8 * pass)) & 0xff] == n)
+        continue;
+
+      for (b = 0; b < 256; b++)
+        {
+          guint bucket = c[b];
+          c[b] = sum;
+          sum += bucket;
+        }
+
+      for (i = 0; i < n; i++)
+        tmp[c[(items[i].key >> (8 * pass)) & 0xff]++] = items[i];
+
+      swap = items;
+      items = tmp;
+      tmp = swap;
+    }
+
+  return items;
+}
+
+/* Sort by x and then (stably) by y, so that the result is sorted by y with
+ * ties broken by x. Always leaves the result in run->items */
+static gpointer
+p2t_sort_run (gpointer data)
+{
+  P2tSortRun *run = (P2tSortRun*) data;
+  P2tSortItem *result;
+  guint i;
+
+  for (i = 0; i < run->n; i++)
+    run->items[i].key = p2t_sort_key (run->items[i].point->x);
+  result = p2t_sort_radix (run->items, run->tmp, run->n);
+
+  for (i = 0; i < run->n; i++)
+    result[i].key = p2t_sort_key (result[i].point->y);
+  result = p2t_sort_radix (result, (result == run->items) ? run->tmp : run->items, run->n);
+
+  if (result != run->items)
+    memcpy (run->items, result, run->n * sizeof (P2tSortItem));
+
+  return NULL;
+}
+
+/* Stable merge of two sorted ranges. The keys hold the y coordinates, so
+ * only ties need to look at the points */
+static void
+p2t_sort_merge (const P2tSortItem *a, guint na, const P2tSortItem *b, guint nb, P2tSortItem *dest)
+{
+  guint i = 0, j = 0;
+
+  while (i < na && j < nb)
+    {
+      if (b[j].key < a[i].key
+          || (b[j].key == a[i].key && b[j].point->x < a[i].point->x))
+        *dest++ = b[j++];
+      else
+        *dest++ = a[i++];
+    }
+
+  memcpy (dest, a + i, (na - i) * sizeof (P2tSortItem));
+  memcpy (dest + (na - i), b + j, (nb - j) * sizeof (P2tSortItem));
+}
+
+void
+p2t_point_array_sort (P2tPointPtrArray points, guint n_threads, GByteArray *scratch)
+{
+  guint n = points->len;
+  P2tSortItem *items, *tmp;
+  P2tSortRun single_run, *runs;
+  guint n_runs, i;
+
+  if (n < P2T_SORT_RADIX_MIN)
+    {
+      g_ptr_array_sort (points, p2t_point_cmp);
+      return;
+    }
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  n_runs = MAX (1, MIN (n_threads, n / P2T_SORT_THREAD_MIN));
+
+  if (scratch != NULL)
+    {
+      g_byte_array_set_size (scratch, 2 * n * sizeof (P2tSortItem));
+      items = (P2tSortItem*) scratch->data;
+    }
+  else
+    items = g_new (P2tSortItem, 2 * n);
+  tmp = items + n;
+  runs = (n_runs == 1) ? &single_run : g_new (P2tSortRun, n_runs);
+
+  for (i = 0; i < n; i++)
+    items[i].point = point_index (points, i);
+
+  for (i = 0; i < n_runs; i++)
+    {
+      guint start = (guint) ((guint64) n * i / n_runs);
+      guint end = (guint) ((guint64) n * (i + 1) / n_runs);
+      runs[i].items = items + start;
+      runs[i].tmp = tmp + start;
+      runs[i].n = end - start;
+    }
+
+  if (n_runs == 1)
+    p2t_sort_run (&runs[0]);
+  else
+    {
+      GThread **threads = g_new (GThread*, n_runs);
+
+      for (i = 1; i < n_runs; i++)
+        threads[i] = g_thread_new ("p2t-sort", p2t_sort_run, &runs[i]);
+      p2t_sort_run (&runs[0]);
+      for (i = 1; i < n_runs; i++)
+        g_thread_join (threads[i]);
+
+      g_free (threads);
+    }
+
+  /* Merge adjacent runs until only one is left. Merging the earlier run
+   * first on ties keeps the sort stable */
+  while (n_runs > 1)
+    {
+      P2tSortItem *swap;
+      guint merged = 0;
+
+      for (i = 0; i < n_runs; i += 2)
+        {
+          P2tSortItem *dest = tmp + (runs[i].items - items);
+          if (i + 1 < n_runs)
+            {
+              p2t_sort_merge (runs[i].items, runs[i].n, runs[i + 1].items, runs[i + 1].n, dest);
+              runs[merged].n = runs[i].n + runs[i + 1].n;
+            }
+          else
+            {
+              memcpy (dest, runs[i].items, runs[i].n * sizeof (P2tSortItem));
+              runs[merged].n = runs[i].n;
+            }
+          runs[merged].items = dest;
+          merged++;
+        }
+
+      /* The merged runs now live in tmp, which becomes the source */
+      swap = items;
+      items = tmp;
+      tmp = swap;
+      n_runs = merged;
+    }
+
+  for (i = 0; i < n; i++)
+    points->pdata[i] = items[i].point;
+
+  if (runs != &single_run)
+    g_free (runs);
+  /* The merges may have swapped the two halves */
+  if (scratch == NULL)
+    g_free (MIN (items, tmp));
+}
@@ -0,0 +1,66 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __P2TC_P2T_SORT_H__
+#define __P2TC_P2T_SORT_H__
+
+#include <glib.h>
+#include "poly2tri-private.h"
+#include "cutils.h"
+
+/* Below this amount of points, a plain comparison sort is used */
+#define P2T_SORT_RADIX_MIN 256
+
+/* The minimal amount of points for each thread of a parallel sort */
+#define P2T_SORT_THREAD_MIN 65536
+
+/**
+ * p2t_point_array_sort:
+ * @points: The points to sort
+ * @n_threads: The maximal amount of threads to use, or 0 to use one thread
+ *             per processor
+ * @scratch: A buffer for the temporary storage of the sort, or %NULL to
+ *           allocate (and free) one for this call. The buffer only grows,
+ *           so passing the same one again sorts without allocating
+ *
+ * Sort the points in the order of the sweep - by their y coordinate and
+ * then by their x coordinate. This gives exactly the same (stable) order as
+ * sorting with #p2t_point_cmp, but uses a radix sort on the coordinates.
+ * Large arrays are split between several threads, and the sorted parts are
+ * merged at the end.
+ */
+void p2t_point_array_sort (P2tPointPtrArray points, guint n_threads, GByteArray *scratch);
+
+#endif
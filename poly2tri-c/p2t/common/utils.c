@@ -35,6 +35,7 @@
 
 #include <math.h>
 #include "utils.h"
+#include "predicates.h"
 
 /**
  * Forumla to calculate signed area<br>
@@ -45,14 +46,14 @@
  * A[P1,P2,P3]  =  (x1*y2 - y1*x2) + (x2*y3 - y2*x3) + (x3*y1 - y3*x1)
  *              =  (x1-x3)*(y2-y3) - (y1-y3)*(x2-x3)
  * </pre>
+ * The sign is computed exactly, so only truly collinear points are
+ * reported as collinear
  */
 P2tOrientation
 p2t_orient2d (P2tPoint* pa, P2tPoint* pb, P2tPoint* pc)
 {
-  double detleft = (pa->x - pc->x) * (pb->y - pc->y);
-  double detright = (pa->y - pc->y) * (pb->x - pc->x);
-  double val = detleft - detright;
-  if (val > -EPSILON && val < EPSILON)
+  double val = p2t_predicates_orient2d (pa->x, pa->y, pb->x, pb->y, pc->x, pc->y);
+  if (val == 0)
     {
       return COLLINEAR;
     }
@@ -100,13 +101,13 @@ p2t_utils_in_scan_area (P2tPoint* pa, P2tPoint* pb, P2tPoint* pc, P2tPoint* pd)
 
   return TRUE;
 #else
-  gdouble oadc, oadb = (pa->x - pb->x)*(pd->y - pb->y) - (pd->x - pb->x)*(pa->y - pb->y);
-  if (oadb >= -EPSILON) {
+  /* oadb = (pa->x - pb->x)*(pd->y - pb->y) - (pd->x - pb->x)*(pa->y - pb->y) */
+  if (p2t_predicates_orient2d (pa->x, pa->y, pd->x, pd->y, pb->x, pb->y) >= 0) {
     return FALSE;
   }
 
-  oadc = (pa->x - pc->x)*(pd->y - pc->y) - (pd->x - pc->x)*(pa->y - pc->y);
-  if (oadc <= EPSILON) {
+  /* oadc = (pa->x - pc->x)*(pd->y - pc->y) - (pd->x - pc->x)*(pa->y - pc->y) */
+  if (p2t_predicates_orient2d (pa->x, pa->y, pd->x, pd->y, pc->x, pc->y) <= 0) {
     return FALSE;
   }
   return TRUE;
@@ -38,6 +38,8 @@
 
 #include "common/shapes.h"
 #include "sweep/cdt.h"
+#include "sweep/batch.h"
+#include "sweep/sanitize.h"
 
 #endif
 
@@ -43,6 +43,7 @@ p2t_node_init_pt (P2tNode* THIS, P2tPoint* p)
   THIS->value = p->x;
   THIS->next = NULL;
   THIS->prev = NULL;
+  THIS->index_iter = NULL;
 }
 
 P2tNode*
@@ -61,6 +62,7 @@ p2t_node_init_pt_tr (P2tNode* THIS, P2tPoint* p, P2tTriangle* t)
   THIS->value = p->x;
   THIS->next = NULL;
   THIS->prev = NULL;
+  THIS->index_iter = NULL;
 }
 
 P2tNode*
@@ -86,6 +88,7 @@ p2t_advancingfront_init (P2tAdvancingFront* THIS, P2tNode* head, P2tNode* tail)
   THIS->head_ = head;
   THIS->tail_ = tail;
   THIS->search_node_ = head;
+  THIS->index_ = NULL;
 }
 
 P2tAdvancingFront*
@@ -97,7 +100,11 @@ p2t_advancingfront_new (P2tNode* head, P2tNode* tail)
 }
 
 void
-p2t_advancingfront_destroy (P2tAdvancingFront* THIS) { }
+p2t_advancingfront_destroy (P2tAdvancingFront* THIS)
+{
+  if (THIS->index_ != NULL)
+    g_sequence_free (THIS->index_);
+}
 
 void
 p2t_advancingfront_free (P2tAdvancingFront* THIS)
@@ -106,11 +113,72 @@ p2t_advancingfront_free (P2tAdvancingFront* THIS)
   g_slice_free (P2tAdvancingFront, THIS);
 }
 
+/* Compare a node in the index to the searched x value */
+static gint
+p2t_advancingfront_index_cmp (gconstpointer a, gconstpointer b, gpointer x)
+{
+  const double value = ((const P2tNode*) a)->value;
+  const double search = *(const double*) x;
+  return (value < search) ? -1 : (value > search);
+}
+
+/* Find the last node with a value less than or equal to x */
+static P2tNode*
+p2t_advancingfront_index_locate (P2tAdvancingFront *THIS, double x)
+{
+  GSequenceIter *iter = g_sequence_search (THIS->index_, NULL, p2t_advancingfront_index_cmp, &x);
+
+  if (g_sequence_iter_is_begin (iter))
+    return NULL;
+  return (P2tNode*) g_sequence_get (g_sequence_iter_prev (iter));
+}
+
+void
+p2t_advancingfront_build_index (P2tAdvancingFront *THIS)
+{
+  P2tNode *node;
+
+  if (THIS->index_ != NULL)
+    return;
+
+  THIS->index_ = g_sequence_new (NULL);
+  for (node = THIS->head_; node != NULL; node = node->next)
+    node->index_iter = g_sequence_append (THIS->index_, node);
+}
+
+void
+p2t_advancingfront_insert (P2tAdvancingFront *THIS, P2tNode* node, P2tNode* new_node)
+{
+  new_node->next = node->next;
+  new_node->prev = node;
+  node->next->prev = new_node;
+  node->next = new_node;
+
+  if (THIS->index_ != NULL)
+    new_node->index_iter = g_sequence_insert_before (g_sequence_iter_next (node->index_iter), new_node);
+}
+
+void
+p2t_advancingfront_remove (P2tAdvancingFront *THIS, P2tNode* node)
+{
+  node->prev->next = node->next;
+  node->next->prev = node->prev;
+
+  if (THIS->index_ != NULL)
+    {
+      g_sequence_remove (node->index_iter);
+      node->index_iter = NULL;
+    }
+}
+
 P2tNode*
 p2t_advancingfront_locate_node (P2tAdvancingFront *THIS, const double x)
 {
   P2tNode* node = THIS->search_node_;
 
+  if (THIS->index_ != NULL)
+    return p2t_advancingfront_index_locate (THIS, x);
+
   if (x < node->value)
     {
       while ((node = node->prev) != NULL)
@@ -147,8 +215,23 @@ P2tNode*
 p2t_advancingfront_locate_point (P2tAdvancingFront *THIS, const P2tPoint* point)
 {
   const double px = point->x;
-  P2tNode* node = p2t_advancingfront_find_search_node (THIS, px);
-  const double nx = node->point->x;
+  P2tNode* node;
+  double nx;
+
+  if (THIS->index_ != NULL)
+    {
+      /* Only the nodes with the same x value may hold the point */
+      for (node = p2t_advancingfront_index_locate (THIS, px);
+           node != NULL && node->value == px; node = node->prev)
+        {
+          if (node->point == point)
+            return node;
+        }
+      return NULL;
+    }
+
+  node = p2t_advancingfront_find_search_node (THIS, px);
+  nx = node->point->x;
 
   if (px == nx)
     {
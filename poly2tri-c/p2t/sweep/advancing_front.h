@@ -50,6 +50,9 @@ struct _P2tNode
   struct _P2tNode* prev;
 
   double value;
+
+  /* The position of the node in the index of the front, if any */
+  GSequenceIter* index_iter;
 };
 
 void p2t_node_init_pt (P2tNode* THIS, P2tPoint* p);
@@ -67,6 +70,10 @@ struct AdvancingFront_
 
   P2tNode* head_, *tail_, *search_node_;
 
+  /* An ordered index of the nodes by their x value, or NULL to search by
+   * walking the list from search_node_ */
+  GSequence* index_;
+
 };
 
 void p2t_advancingfront_init (P2tAdvancingFront* THIS, P2tNode* head, P2tNode* tail);
@@ -89,4 +96,15 @@ P2tNode* p2t_advancingfront_locate_point (P2tAdvancingFront *THIS, const P2tPoin
 
 P2tNode* p2t_advancingfront_find_search_node (P2tAdvancingFront *THIS, const double x);
 
+/** Build an ordered index over the nodes currently in the front, so that
+ * locating nodes takes logarithmic time no matter how wide the front is.
+ * From now on, the front must only be modified with insert and remove */
+void p2t_advancingfront_build_index (P2tAdvancingFront *THIS);
+
+/** Insert a new node into the front, right after the given node */
+void p2t_advancingfront_insert (P2tAdvancingFront *THIS, P2tNode* node, P2tNode* new_node);
+
+/** Unlink a node from the front (the node itself is not freed) */
+void p2t_advancingfront_remove (P2tAdvancingFront *THIS, P2tNode* node);
+
 #endif
@@ -0,0 +1,343 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <glib.h>
+
+#include "batch.h"
+#include "cdt.h"
+
+struct _P2tBatchWorker
+{
+  P2tBatch *batch;
+  guint     index;
+  /* Created for the first polygon of the worker, then reset for each of
+   * the following ones */
+  P2tCDT   *cdt;
+  /* The triangle points of all the polygons done by this worker */
+  P2tPointPtrArray points;
+
+  /* Copies of the points of the current polygon. The sweep writes into
+   * the points it triangulates, so it must not be given points which
+   * other polygons (maybe on other workers) may share */
+  P2tPoint  *copies;
+  /* The input point of each copy */
+  P2tPoint **originals;
+  guint      copies_size;
+  /* The outline and then the holes of the current polygon, made of the
+   * copies. Each is a P2tPointPtrArray, kept from one polygon to the next */
+  GPtrArray *rings;
+};
+
+typedef struct
+{
+  guint worker;
+  guint offset;
+  guint n_triangles;
+} P2tBatchResult;
+
+static gpointer p2t_batch_thread_run (gpointer data);
+
+P2tBatch*
+p2t_batch_new (guint n_threads)
+{
+  P2tBatch *THIS = g_slice_new (P2tBatch);
+  guint i;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  THIS->n_workers_ = n_threads;
+  THIS->workers_ = g_new (P2tBatchWorker, n_threads);
+  for (i = 0; i < n_threads; i++)
+    {
+      THIS->workers_[i].batch = THIS;
+      THIS->workers_[i].index = i;
+      THIS->workers_[i].cdt = NULL;
+      THIS->workers_[i].points = g_ptr_array_new ();
+      THIS->workers_[i].copies = NULL;
+      THIS->workers_[i].originals = NULL;
+      THIS->workers_[i].copies_size = 0;
+      THIS->workers_[i].rings = g_ptr_array_new ();
+    }
+
+  THIS->polygons_ = NULL;
+  THIS->n_polygons_ = 0;
+  THIS->next_ = 0;
+  THIS->results_ = g_array_new (FALSE, FALSE, sizeof (P2tBatchResult));
+
+  g_mutex_init (&THIS->lock_);
+  g_cond_init (&THIS->start_);
+  g_cond_init (&THIS->done_);
+  THIS->generation_ = 0;
+  THIS->running_ = 0;
+  THIS->quit_ = FALSE;
+
+  /* The first worker runs on the thread calling p2t_batch_triangulate */
+  THIS->threads_ = g_new (GThread*, n_threads);
+  for (i = 1; i < n_threads; i++)
+    THIS->threads_[i] = g_thread_new ("p2t-batch", p2t_batch_thread_run, &THIS->workers_[i]);
+
+  return THIS;
+}
+
+void
+p2t_batch_free (P2tBatch *THIS)
+{
+  guint i, j;
+
+  g_mutex_lock (&THIS->lock_);
+  THIS->quit_ = TRUE;
+  g_cond_broadcast (&THIS->start_);
+  g_mutex_unlock (&THIS->lock_);
+
+  for (i = 1; i < THIS->n_workers_; i++)
+    g_thread_join (THIS->threads_[i]);
+  g_free (THIS->threads_);
+
+  g_mutex_clear (&THIS->lock_);
+  g_cond_clear (&THIS->start_);
+  g_cond_clear (&THIS->done_);
+
+  for (i = 0; i < THIS->n_workers_; i++)
+    {
+      P2tBatchWorker *worker = &THIS->workers_[i];
+
+      if (worker->cdt != NULL)
+        p2t_cdt_free (worker->cdt);
+      g_ptr_array_free (worker->points, TRUE);
+
+      g_free (worker->copies);
+      g_free (worker->originals);
+      for (j = 0; j < worker->rings->len; j++)
+        g_ptr_array_free (g_ptr_array_index (worker->rings, j), TRUE);
+      g_ptr_array_free (worker->rings, TRUE);
+    }
+  g_free (THIS->workers_);
+  g_array_free (THIS->results_, TRUE);
+
+  g_slice_free (P2tBatch, THIS);
+}
+
+/* Copy the points of @input, starting at the copy @first, and add the
+ * copies to @ring if it is not NULL. Returns the first copy after them */
+static guint
+p2t_batch_worker_copy_points (P2tBatchWorker *THIS, P2tPointPtrArray input, guint first, P2tPointPtrArray ring)
+{
+  guint i;
+
+  for (i = 0; i < input->len; i++)
+    {
+      P2tPoint *point = point_index (input, i);
+
+      p2t_point_init_dd (&THIS->copies[first + i], point->x, point->y);
+      THIS->originals[first + i] = point;
+      if (ring != NULL)
+        g_ptr_array_add (ring, &THIS->copies[first + i]);
+    }
+
+  return first + input->len;
+}
+
+/* Copy all the points of a polygon, and build its rings from the copies.
+ * Returns the first copy of the Steiner points */
+static guint
+p2t_batch_worker_copy_polygon (P2tBatchWorker *THIS, const P2tBatchPolygon *polygon)
+{
+  guint n_points = polygon->outline->len;
+  guint i, next;
+
+  for (i = 0; i < polygon->n_holes; i++)
+    n_points += polygon->holes[i]->len;
+  if (polygon->steiner_points != NULL)
+    n_points += polygon->steiner_points->len;
+
+  if (n_points > THIS->copies_size)
+    {
+      THIS->copies_size = MAX (n_points, 2 * THIS->copies_size);
+      g_free (THIS->copies);
+      g_free (THIS->originals);
+      THIS->copies = g_new (P2tPoint, THIS->copies_size);
+      THIS->originals = g_new (P2tPoint*, THIS->copies_size);
+    }
+
+  while (THIS->rings->len < polygon->n_holes + 1)
+    g_ptr_array_add (THIS->rings, g_ptr_array_new ());
+
+  next = 0;
+  for (i = 0; i <= polygon->n_holes; i++)
+    {
+      P2tPointPtrArray ring = (P2tPointPtrArray) g_ptr_array_index (THIS->rings, i);
+
+      g_ptr_array_set_size (ring, 0);
+      next = p2t_batch_worker_copy_points (THIS, (i == 0) ? polygon->outline : polygon->holes[i - 1],
+                                           next, ring);
+    }
+
+  if (polygon->steiner_points != NULL)
+    p2t_batch_worker_copy_points (THIS, polygon->steiner_points, next, NULL);
+
+  return next;
+}
+
+static void
+p2t_batch_worker_triangulate (P2tBatchWorker *THIS, const P2tBatchPolygon *polygon, P2tBatchResult *result)
+{
+  P2tTrianglePtrArray triangles;
+  guint i, steiner;
+  int j;
+
+  steiner = p2t_batch_worker_copy_polygon (THIS, polygon);
+
+  if (THIS->cdt == NULL)
+    THIS->cdt = p2t_cdt_new (g_ptr_array_index (THIS->rings, 0));
+  else
+    p2t_cdt_reset (THIS->cdt, g_ptr_array_index (THIS->rings, 0));
+
+  for (i = 0; i < polygon->n_holes; i++)
+    p2t_cdt_add_hole (THIS->cdt, g_ptr_array_index (THIS->rings, i + 1));
+  if (polygon->steiner_points != NULL)
+    for (i = 0; i < polygon->steiner_points->len; i++)
+      p2t_cdt_add_point (THIS->cdt, &THIS->copies[steiner + i]);
+
+  p2t_cdt_triangulate (THIS->cdt);
+  triangles = p2t_cdt_get_triangles (THIS->cdt);
+
+  result->worker = THIS->index;
+  result->offset = THIS->points->len;
+  result->n_triangles = triangles->len;
+
+  /* All the points of the triangles are copies of input points */
+  for (i = 0; i < triangles->len; i++)
+    for (j = 0; j < 3; j++)
+      {
+        P2tPoint *copy = p2t_triangle_get_point (triangle_index (triangles, i), j);
+        g_ptr_array_add (THIS->points, THIS->originals[copy - THIS->copies]);
+      }
+}
+
+/* Take chunks of polygons until none are left. Workers which finish early
+ * just take more chunks, which balances polygons of different sizes */
+static void
+p2t_batch_worker_run (P2tBatchWorker *THIS)
+{
+  P2tBatch *batch = THIS->batch;
+
+  while (TRUE)
+    {
+      guint start = (guint) g_atomic_int_add (&batch->next_, P2T_BATCH_CHUNK_SIZE);
+      guint i, end;
+
+      if (start >= batch->n_polygons_)
+        break;
+
+      end = MIN (start + P2T_BATCH_CHUNK_SIZE, batch->n_polygons_);
+      for (i = start; i < end; i++)
+        p2t_batch_worker_triangulate (THIS, &batch->polygons_[i],
+                                      &g_array_index (batch->results_, P2tBatchResult, i));
+    }
+}
+
+/* The main function of the threads of the workers: wait for a batch, work
+ * on it, and wait for the next one until the batch triangulator is freed */
+static gpointer
+p2t_batch_thread_run (gpointer data)
+{
+  P2tBatchWorker *THIS = (P2tBatchWorker*) data;
+  P2tBatch *batch = THIS->batch;
+  guint generation = 0;
+
+  g_mutex_lock (&batch->lock_);
+  while (TRUE)
+    {
+      while (batch->generation_ == generation && ! batch->quit_)
+        g_cond_wait (&batch->start_, &batch->lock_);
+      if (batch->quit_)
+        break;
+      generation = batch->generation_;
+      g_mutex_unlock (&batch->lock_);
+
+      p2t_batch_worker_run (THIS);
+
+      g_mutex_lock (&batch->lock_);
+      if (--batch->running_ == 0)
+        g_cond_signal (&batch->done_);
+    }
+  g_mutex_unlock (&batch->lock_);
+
+  return NULL;
+}
+
+void
+p2t_batch_triangulate (P2tBatch *THIS, const P2tBatchPolygon *polygons, guint n_polygons)
+{
+  guint i;
+
+  g_return_if_fail (n_polygons <= G_MAXINT - THIS->n_workers_ * P2T_BATCH_CHUNK_SIZE);
+
+  for (i = 0; i < THIS->n_workers_; i++)
+    g_ptr_array_set_size (THIS->workers_[i].points, 0);
+
+  THIS->polygons_ = polygons;
+  THIS->n_polygons_ = n_polygons;
+  g_atomic_int_set (&THIS->next_, 0);
+  g_array_set_size (THIS->results_, n_polygons);
+
+  g_mutex_lock (&THIS->lock_);
+  THIS->generation_++;
+  THIS->running_ = THIS->n_workers_ - 1;
+  g_cond_broadcast (&THIS->start_);
+  g_mutex_unlock (&THIS->lock_);
+
+  p2t_batch_worker_run (&THIS->workers_[0]);
+
+  g_mutex_lock (&THIS->lock_);
+  while (THIS->running_ > 0)
+    g_cond_wait (&THIS->done_, &THIS->lock_);
+  g_mutex_unlock (&THIS->lock_);
+
+  THIS->polygons_ = NULL;
+}
+
+P2tPoint**
+p2t_batch_get_triangles (P2tBatch *THIS, guint polygon, guint *n_triangles)
+{
+  P2tBatchResult *result;
+
+  g_return_val_if_fail (polygon < THIS->results_->len, NULL);
+
+  result = &g_array_index (THIS->results_, P2tBatchResult, polygon);
+  *n_triangles = result->n_triangles;
+  return (P2tPoint**) THIS->workers_[result->worker].points->pdata + result->offset;
+}
@@ -0,0 +1,141 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __P2TC_P2T_BATCH_H__
+#define __P2TC_P2T_BATCH_H__
+
+#include "../common/poly2tri-private.h"
+#include "../common/shapes.h"
+
+/* The amount of polygons a worker takes from the batch at once */
+#define P2T_BATCH_CHUNK_SIZE 16
+
+/**
+ * P2tBatchPolygon:
+ * @outline: The outline of the polygon, with non repeating points
+ * @holes: An array of @n_holes hole outlines, or %NULL if there are none
+ * @n_holes: The amount of holes
+ * @steiner_points: Points to add inside the polygon, or %NULL
+ *
+ * The description of one polygon in a batch. The points are only
+ * referenced, and must stay alive as long as the results of the batch are
+ * used. They are never modified, so different polygons may share point
+ * objects (for example adjacent parcels of a map).
+ */
+struct _P2tBatchPolygon
+{
+  P2tPointPtrArray  outline;
+  P2tPointPtrArray *holes;
+  guint             n_holes;
+  P2tPointPtrArray  steiner_points;
+};
+
+/**
+ * P2tBatch:
+ *
+ * Triangulates many independent polygons on several threads. The worker
+ * threads are created with the batch triangulator and wait for work
+ * between batches, so a batch does not pay for starting threads. Each
+ * worker triangulates copies of the points of its polygons, and reuses
+ * its own #P2tCDT (and so its own arena) from one polygon to the next,
+ * and from one batch to the next. The triangles are copied into a buffer
+ * of the worker, mapped back to the points of the input, and are
+ * available in the order of the input until the next batch is
+ * triangulated.
+ */
+struct _P2tBatch
+{
+  /*< private >*/
+  P2tBatchWorker *workers_;
+  guint           n_workers_;
+
+  const P2tBatchPolygon *polygons_;
+  guint                  n_polygons_;
+  /** The first polygon which no worker took yet */
+  volatile gint          next_;
+  /** The results of the polygons, in the input order */
+  GArray                *results_;
+
+  /** The threads of all the workers except the first, whose work is done
+   * by the thread calling #p2t_batch_triangulate */
+  GThread              **threads_;
+  /** Protects the fields below, which tell the threads when to work */
+  GMutex                 lock_;
+  /** Signalled when a batch starts, or when the threads should exit */
+  GCond                  start_;
+  /** Signalled when the last thread finishes its part of a batch */
+  GCond                  done_;
+  /** Counts the batches, so that each thread takes part in each once */
+  guint                  generation_;
+  /** The amount of threads still working on the current batch */
+  guint                  running_;
+  gboolean               quit_;
+};
+
+/**
+ * p2t_batch_new:
+ * @n_threads: The amount of worker threads, or 0 to use one per processor
+ *
+ * Returns: A new batch triangulator, to be freed with #p2t_batch_free
+ */
+P2tBatch* p2t_batch_new (guint n_threads);
+
+void p2t_batch_free (P2tBatch *THIS);
+
+/**
+ * p2t_batch_triangulate:
+ * @THIS: The batch triangulator
+ * @polygons: The polygons to triangulate
+ * @n_polygons: The amount of polygons
+ *
+ * Triangulate all the polygons, and wait until all are done. The calling
+ * thread is used as one of the workers. The results of the previous call
+ * are released.
+ */
+void p2t_batch_triangulate (P2tBatch *THIS, const P2tBatchPolygon *polygons, guint n_polygons);
+
+/**
+ * p2t_batch_get_triangles:
+ * @THIS: The batch triangulator
+ * @polygon: The index of the polygon in the last batch
+ * @n_triangles: Return location for the amount of triangles
+ *
+ * Returns: The points of the triangles of the polygon, three for each
+ *          triangle in counter-clockwise order. The array is owned by the
+ *          batch and is valid until the next batch is triangulated
+ */
+P2tPoint** p2t_batch_get_triangles (P2tBatch *THIS, guint polygon, guint *n_triangles);
+
+#endif
@@ -33,6 +33,7 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <math.h>
 #include "cdt.h"
 
 void
@@ -40,6 +41,11 @@ p2t_cdt_init (P2tCDT* THIS, P2tPointPtrArray polyline)
 {
   THIS->sweep_context_ = p2t_sweepcontext_new (polyline);
   THIS->sweep_ = p2t_sweep_new ();
+  THIS->xy_points_ = NULL;
+  THIS->n_xy_points_ = 0;
+  THIS->normalize_ = FALSE;
+  THIS->origin_x_ = THIS->origin_y_ = 0;
+  THIS->scale_ = 1;
 }
 
 P2tCDT*
@@ -50,11 +56,150 @@ p2t_cdt_new (P2tPointPtrArray polyline)
   return THIS;
 }
 
+void
+p2t_cdt_init_point_cloud (P2tCDT* THIS, P2tPointPtrArray points)
+{
+  THIS->sweep_context_ = p2t_sweepcontext_new_point_cloud (points);
+  THIS->sweep_ = p2t_sweep_new ();
+  THIS->xy_points_ = NULL;
+  THIS->n_xy_points_ = 0;
+  THIS->normalize_ = FALSE;
+  THIS->origin_x_ = THIS->origin_y_ = 0;
+  THIS->scale_ = 1;
+}
+
+P2tCDT*
+p2t_cdt_new_point_cloud (P2tPointPtrArray points)
+{
+  P2tCDT* THIS = g_slice_new (P2tCDT);
+  p2t_cdt_init_point_cloud (THIS, points);
+  return THIS;
+}
+
+/* Add the pieces of the segments of a resolved graph to a point cloud */
+static void
+p2t_cdt_pslg_edges (P2tCDT* THIS, P2tPslg *pslg)
+{
+  GArray *edges = p2t_pslg_get_edges (pslg);
+  guint i;
+
+  for (i = 0; i < edges->len; i++)
+    {
+      P2tEdge *edge = &g_array_index (edges, P2tEdge, i);
+      p2t_sweepcontext_add_edge (THIS->sweep_context_, edge->p, edge->q);
+    }
+}
+
+void
+p2t_cdt_init_pslg (P2tCDT* THIS, P2tPslg *pslg)
+{
+  p2t_pslg_resolve (pslg);
+  p2t_cdt_init_point_cloud (THIS, p2t_pslg_get_points (pslg));
+  p2t_cdt_pslg_edges (THIS, pslg);
+}
+
+P2tCDT*
+p2t_cdt_new_pslg (P2tPslg *pslg)
+{
+  P2tCDT* THIS = g_slice_new (P2tCDT);
+  p2t_cdt_init_pslg (THIS, pslg);
+  return THIS;
+}
+
+static void
+p2t_cdt_xy_polyline (P2tPointPtrArray polyline, P2tPoint *points, guint start, guint end)
+{
+  guint i;
+
+  g_ptr_array_set_size (polyline, 0);
+  for (i = start; i < end; i++)
+    g_ptr_array_add (polyline, &points[i]);
+}
+
+void
+p2t_cdt_init_xy (P2tCDT* THIS, const double *xy, guint n_points, const guint *hole_offsets, guint n_holes)
+{
+  P2tPoint *points = g_new (P2tPoint, n_points);
+  P2tPointPtrArray polyline;
+  guint i, end;
+
+  for (i = 0; i < n_points; i++)
+    p2t_point_init_dd (&points[i], xy[2 * i], xy[2 * i + 1]);
+
+  end = (n_holes > 0) ? hole_offsets[0] : n_points;
+  polyline = g_ptr_array_sized_new (end);
+  p2t_cdt_xy_polyline (polyline, points, 0, end);
+  p2t_cdt_init (THIS, polyline);
+
+  for (i = 0; i < n_holes; i++)
+    {
+      guint start = hole_offsets[i];
+      end = (i + 1 < n_holes) ? hole_offsets[i + 1] : n_points;
+      g_assert (start <= end && end <= n_points);
+
+      p2t_cdt_xy_polyline (polyline, points, start, end);
+      p2t_cdt_add_hole (THIS, polyline);
+    }
+
+  g_ptr_array_free (polyline, TRUE);
+
+  THIS->xy_points_ = points;
+  THIS->n_xy_points_ = n_points;
+}
+
+P2tCDT*
+p2t_cdt_new_xy (const double *xy, guint n_points, const guint *hole_offsets, guint n_holes)
+{
+  P2tCDT* THIS = g_slice_new (P2tCDT);
+  p2t_cdt_init_xy (THIS, xy, n_points, hole_offsets, n_holes);
+  return THIS;
+}
+
+static void
+p2t_cdt_free_xy_points (P2tCDT* THIS)
+{
+  guint i;
+
+  for (i = 0; i < THIS->n_xy_points_; i++)
+    p2t_point_destroy (&THIS->xy_points_[i]);
+  g_free (THIS->xy_points_);
+
+  THIS->xy_points_ = NULL;
+  THIS->n_xy_points_ = 0;
+}
+
+void
+p2t_cdt_reset (P2tCDT* THIS, P2tPointPtrArray polyline)
+{
+  /* The points of a previous p2t_cdt_new_xy input are not used anymore */
+  p2t_cdt_free_xy_points (THIS);
+
+  p2t_sweepcontext_reset (THIS->sweep_context_, polyline);
+}
+
+void
+p2t_cdt_reset_point_cloud (P2tCDT* THIS, P2tPointPtrArray points)
+{
+  p2t_cdt_free_xy_points (THIS);
+
+  p2t_sweepcontext_reset_point_cloud (THIS->sweep_context_, points);
+}
+
+void
+p2t_cdt_reset_pslg (P2tCDT* THIS, P2tPslg *pslg)
+{
+  p2t_pslg_resolve (pslg);
+  p2t_cdt_reset_point_cloud (THIS, p2t_pslg_get_points (pslg));
+  p2t_cdt_pslg_edges (THIS, pslg);
+}
+
 void
 p2t_cdt_destroy (P2tCDT* THIS)
 {
   p2t_sweepcontext_delete (THIS->sweep_context_);
   p2t_sweep_free (THIS->sweep_);
+
+  p2t_cdt_free_xy_points (THIS);
 }
 
 void
@@ -76,10 +221,160 @@ p2t_cdt_add_point (P2tCDT *THIS, P2tPoint* point)
   p2t_sweepcontext_add_point (THIS->sweep_context_, point);
 }
 
+void
+p2t_cdt_set_presorted (P2tCDT *THIS, gboolean presorted)
+{
+  p2t_sweepcontext_set_presorted (THIS->sweep_context_, presorted);
+}
+
+void
+p2t_cdt_set_sort_threads (P2tCDT *THIS, guint n_threads)
+{
+  p2t_sweepcontext_set_sort_threads (THIS->sweep_context_, n_threads);
+}
+
+void
+p2t_cdt_set_sweep_threads (P2tCDT *THIS, guint n_threads)
+{
+  p2t_sweepcontext_set_sweep_threads (THIS->sweep_context_, n_threads);
+}
+
+void
+p2t_cdt_set_front_index (P2tCDT *THIS, gboolean front_index)
+{
+  p2t_sweepcontext_set_front_index (THIS->sweep_context_, front_index);
+}
+
+void
+p2t_cdt_set_monotone_mode (P2tCDT *THIS, P2tMonotoneMode mode)
+{
+  p2t_sweepcontext_set_monotone_mode (THIS->sweep_context_, mode);
+}
+
+void
+p2t_cdt_set_normalize (P2tCDT *THIS, gboolean normalize)
+{
+  THIS->normalize_ = normalize;
+}
+
+/* Is a - b computed exactly? The rounding error of the difference is
+ * found as in the Two_Diff of the predicates */
+static gboolean
+p2t_cdt_exact_diff (double a, double b)
+{
+  double x = a - b;
+  double bvirt = a - x;
+  double avirt = x + bvirt;
+  double bround = bvirt - b;
+  double around = a - avirt;
+  return around + bround == 0;
+}
+
+/* Choose the local frame of the input points, and move them into it.
+ * Returns FALSE (leaving the points as they are) if there is no frame in
+ * which all of them are represented exactly */
+static gboolean
+p2t_cdt_enter_frame (P2tCDT *THIS)
+{
+  P2tSweepContext *tcx = THIS->sweep_context_;
+  guint n = p2t_sweepcontext_point_count (tcx), i;
+  double xmin, xmax, ymin, ymax, half;
+  int e;
+
+  if (n == 0)
+    return FALSE;
+
+  xmin = xmax = p2t_sweepcontext_get_point (tcx, 0)->x;
+  ymin = ymax = p2t_sweepcontext_get_point (tcx, 0)->y;
+  for (i = 1; i < n; i++)
+    {
+      P2tPoint *p = p2t_sweepcontext_get_point (tcx, i);
+      xmin = MIN (xmin, p->x);
+      xmax = MAX (xmax, p->x);
+      ymin = MIN (ymin, p->y);
+      ymax = MAX (ymax, p->y);
+    }
+
+  half = MAX (xmax - xmin, ymax - ymin) / 2;
+  if (! (half > 0))
+    return FALSE;
+
+  /* Scaling by a power of two is exact, and so is moving by a multiple of
+   * it in most cases - which is checked below */
+  frexp (half, &e);
+  THIS->scale_ = ldexp (1, -e);
+  THIS->origin_x_ = ldexp (floor (ldexp (xmin + (xmax - xmin) / 2, -e) + 0.5), e);
+  THIS->origin_y_ = ldexp (floor (ldexp (ymin + (ymax - ymin) / 2, -e) + 0.5), e);
+
+  for (i = 0; i < n; i++)
+    {
+      P2tPoint *p = p2t_sweepcontext_get_point (tcx, i);
+      double x = (p->x - THIS->origin_x_) * THIS->scale_;
+      double y = (p->y - THIS->origin_y_) * THIS->scale_;
+
+      if (! p2t_cdt_exact_diff (p->x, THIS->origin_x_) || ! p2t_cdt_exact_diff (p->y, THIS->origin_y_)
+          || x / THIS->scale_ != p->x - THIS->origin_x_ || y / THIS->scale_ != p->y - THIS->origin_y_)
+        return FALSE;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      P2tPoint *p = p2t_sweepcontext_get_point (tcx, i);
+      p->x = (p->x - THIS->origin_x_) * THIS->scale_;
+      p->y = (p->y - THIS->origin_y_) * THIS->scale_;
+    }
+  return TRUE;
+}
+
+static void
+p2t_cdt_leave_frame_point (P2tCDT *THIS, P2tPoint *p)
+{
+  p->x = p->x / THIS->scale_ + THIS->origin_x_;
+  p->y = p->y / THIS->scale_ + THIS->origin_y_;
+}
+
+/* Move the points back from the local frame - exactly, since they were
+ * moved into it exactly */
+static void
+p2t_cdt_leave_frame (P2tCDT *THIS)
+{
+  P2tSweepContext *tcx = THIS->sweep_context_;
+  guint n = p2t_sweepcontext_point_count (tcx), i;
+
+  for (i = 0; i < n; i++)
+    p2t_cdt_leave_frame_point (THIS, p2t_sweepcontext_get_point (tcx, i));
+
+  /* The two points of the first triangle are only in the map */
+  if (p2t_sweepcontext_head (tcx) != NULL)
+    p2t_cdt_leave_frame_point (THIS, p2t_sweepcontext_head (tcx));
+  if (p2t_sweepcontext_tail (tcx) != NULL)
+    p2t_cdt_leave_frame_point (THIS, p2t_sweepcontext_tail (tcx));
+
+  THIS->origin_x_ = THIS->origin_y_ = 0;
+  THIS->scale_ = 1;
+}
+
 void
 p2t_cdt_triangulate (P2tCDT *THIS)
 {
+  gboolean framed = THIS->normalize_ && p2t_cdt_enter_frame (THIS);
+
   p2t_sweep_triangulate (THIS->sweep_, THIS->sweep_context_);
+
+  if (framed)
+    p2t_cdt_leave_frame (THIS);
+}
+
+P2tTriangle*
+p2t_cdt_insert_point (P2tCDT *THIS, P2tPoint *point, P2tTriangle *hint)
+{
+  return p2t_sweep_insert_point (THIS->sweep_, THIS->sweep_context_, point, hint);
+}
+
+gboolean
+p2t_cdt_insert_hole (P2tCDT *THIS, P2tPointPtrArray polyline)
+{
+  return p2t_sweep_insert_hole (THIS->sweep_, THIS->sweep_context_, polyline);
 }
 
 P2tTrianglePtrArray
@@ -88,8 +383,41 @@ p2t_cdt_get_triangles (P2tCDT *THIS)
   return p2t_sweepcontext_get_triangles (THIS->sweep_context_);
 }
 
-P2tTrianglePtrList
+P2tTrianglePtrArray
 p2t_cdt_get_map (P2tCDT *THIS)
 {
   return p2t_sweepcontext_get_map (THIS->sweep_context_);
 }
+
+guint
+p2t_cdt_get_point_count (P2tCDT *THIS)
+{
+  return p2t_sweepcontext_point_count (THIS->sweep_context_);
+}
+
+void
+p2t_cdt_get_indexed (P2tCDT *THIS, double *xy, guint32 *indices)
+{
+  P2tTrianglePtrArray triangles = p2t_sweepcontext_get_triangles (THIS->sweep_context_);
+  guint i;
+
+  /* The points are sorted by the sweep, but each still knows its input
+   * position */
+  if (xy != NULL)
+    {
+      for (i = 0; i < p2t_cdt_get_point_count (THIS); i++)
+        {
+          P2tPoint *pt = p2t_sweepcontext_get_point (THIS->sweep_context_, i);
+          xy[2 * pt->index_] = pt->x;
+          xy[2 * pt->index_ + 1] = pt->y;
+        }
+    }
+
+  for (i = 0; i < triangles->len; i++)
+    {
+      P2tTriangle *tr = triangle_index (triangles, i);
+      indices[3 * i] = p2t_triangle_get_point (tr, 0)->index_;
+      indices[3 * i + 1] = p2t_triangle_get_point (tr, 1)->index_;
+      indices[3 * i + 2] = p2t_triangle_get_point (tr, 2)->index_;
+    }
+}
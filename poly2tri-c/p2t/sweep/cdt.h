@@ -40,6 +40,7 @@
 #include "advancing_front.h"
 #include "sweep_context.h"
 #include "sweep.h"
+#include "pslg.h"
 
 /**
  * 
@@ -58,15 +59,97 @@ struct CDT_
   P2tSweepContext* sweep_context_;
   P2tSweep* sweep_;
 
+  /** The points created by #p2t_cdt_new_xy, allocated as one block */
+  P2tPoint* xy_points_;
+  guint n_xy_points_;
+
+  /** Should the sweep run in a local frame of the points? */
+  gboolean normalize_;
+  /** The local frame of the current triangulation: the input point (x, y)
+   * is at ((x - origin_x_) * scale_, (y - origin_y_) * scale_) in it */
+  double origin_x_, origin_y_, scale_;
 };
 /**
  * Constructor - add polyline with non repeating points
  *
+ * The sweep asserts on repeated points, on spikes and on crossing or
+ * touching outlines; use a #P2tSanitizer to check (and repair) the input
+ * first if it is not known to be clean.
+ *
  * @param polyline
  */
 void p2t_cdt_init (P2tCDT* THIS, P2tPointPtrArray polyline);
 P2tCDT* p2t_cdt_new (P2tPointPtrArray polyline);
 
+/**
+ * Constructor - create the polyline and the holes from a flat array of
+ * coordinates, without allocating a separate point for each vertex
+ *
+ * @param xy The coordinates of all the points, as x0, y0, x1, y1, ...
+ * @param n_points The amount of points (half the length of @xy)
+ * @param hole_offsets The index of the first point of each hole. The
+ *                     polyline ends where the first hole begins, and each
+ *                     hole ends where the next one begins. May be NULL if
+ *                     there are no holes
+ * @param n_holes The amount of holes
+ *
+ * The points are allocated in one block which is owned by the CDT, in the
+ * same order as in @xy.
+ */
+void p2t_cdt_init_xy (P2tCDT* THIS, const double *xy, guint n_points, const guint *hole_offsets, guint n_holes);
+P2tCDT* p2t_cdt_new_xy (const double *xy, guint n_points, const guint *hole_offsets, guint n_holes);
+
+/**
+ * Constructor - the Delaunay triangulation of a point cloud, covering the
+ * convex hull of the points. No polyline is needed and holes can not be
+ * added, but more points can still be added with #p2t_cdt_add_point. If
+ * all the points are collinear, the triangulation is empty
+ *
+ * @param points The points to triangulate, with no repeating points
+ */
+void p2t_cdt_init_point_cloud (P2tCDT* THIS, P2tPointPtrArray points);
+P2tCDT* p2t_cdt_new_point_cloud (P2tPointPtrArray points);
+
+/**
+ * Constructor - the constrained Delaunay triangulation of a planar straight
+ * line graph, covering the convex hull of its points. The segments of the
+ * graph may cross, touch and overlap, and may end anywhere: the graph is
+ * resolved (see #p2t_pslg_resolve) and each piece of a segment becomes a
+ * constrained edge, so all of them are triangulated in one sweep
+ *
+ * @param pslg The graph. Its intersection points are used by the
+ *             triangulation, so it must not be cleared, resolved again or
+ *             freed while the CDT is used
+ */
+void p2t_cdt_init_pslg (P2tCDT* THIS, P2tPslg *pslg);
+P2tCDT* p2t_cdt_new_pslg (P2tPslg *pslg);
+
+/**
+ * Start over with a new polyline, as if the CDT was just created with it,
+ * while keeping (and reusing) all of its memory. The triangles of the
+ * previous triangulation are released. The options which were set on the
+ * CDT (sort threads, presorted input, front index) are kept
+ *
+ * @param polyline
+ */
+void p2t_cdt_reset (P2tCDT* THIS, P2tPointPtrArray polyline);
+
+/**
+ * Like #p2t_cdt_reset, but start over with a point cloud (see
+ * #p2t_cdt_new_point_cloud)
+ *
+ * @param points
+ */
+void p2t_cdt_reset_point_cloud (P2tCDT* THIS, P2tPointPtrArray points);
+
+/**
+ * Like #p2t_cdt_reset, but start over with a planar straight line graph
+ * (see #p2t_cdt_new_pslg)
+ *
+ * @param pslg
+ */
+void p2t_cdt_reset_pslg (P2tCDT* THIS, P2tPslg *pslg);
+
 /**
  * Destructor - clean up memory
  */
@@ -87,19 +170,145 @@ void p2t_cdt_add_hole (P2tCDT *THIS, P2tPointPtrArray polyline);
  */
 void p2t_cdt_add_point (P2tCDT *THIS, P2tPoint* point);
 
+/**
+ * Declare that the points are already in sweep order - sorted by y and then
+ * by x, counting the polyline, the holes and the Steiner points in the
+ * order they were added. The sweep will then skip sorting them
+ *
+ * @param presorted
+ */
+void p2t_cdt_set_presorted (P2tCDT *THIS, gboolean presorted);
+
+/**
+ * Set the maximal amount of threads used for sorting the points before the
+ * sweep. The default is 1; 0 means one thread per processor. Threads are
+ * only used for large inputs
+ *
+ * @param n_threads
+ */
+void p2t_cdt_set_sort_threads (P2tCDT *THIS, guint n_threads);
+
+/**
+ * Set the maximal amount of threads used for the sweep itself. The default
+ * is 1; 0 means one thread per processor. With more threads, inputs of at
+ * least #P2T_SLABS_MIN_POINTS points per thread are split into slabs of
+ * consecutive points in the sweep order, which are triangulated at the
+ * same time and then stitched together (see #P2tSlabs). The result is the
+ * constrained Delaunay triangulation, which is what the serial sweep
+ * gives after p2t_sweep_delaunay_flip() - only where four points are on
+ * one circle, the other diagonal may be chosen. The map then holds the
+ * triangles of the convex hull of the points, and no others. Inputs which
+ * give a slab with all of its points on one line are swept serially
+ *
+ * @param n_threads
+ */
+void p2t_cdt_set_sweep_threads (P2tCDT *THIS, guint n_threads);
+
+/**
+ * Choose whether to keep an ordered index of the advancing front. This keeps
+ * locating each point logarithmic even when the front gets very wide (for
+ * example with many scattered Steiner points), at the cost of maintaining
+ * the index. It is off by default
+ *
+ * @param front_index
+ */
+void p2t_cdt_set_front_index (P2tCDT *THIS, gboolean front_index);
+
+/**
+ * Choose how a polygon without holes and without Steiner points is
+ * triangulated. By default (P2T_MONOTONE_AUTO), convex and small y-monotone
+ * polygons are detected in linear time and triangulated without the sweep:
+ * convex polygons directly into a Delaunay triangulation, and monotone ones
+ * with a stack which is then flipped into a constrained Delaunay one.
+ * P2T_MONOTONE_NEVER always uses the sweep, and P2T_MONOTONE_ALWAYS skips
+ * the detection for callers who know that their polygons are y-monotone
+ *
+ * @param mode
+ */
+void p2t_cdt_set_monotone_mode (P2tCDT *THIS, P2tMonotoneMode mode);
+
+/**
+ * Choose whether the sweep runs in a local frame of the points: during
+ * p2t_cdt_triangulate, the points are moved so that their bounding box is
+ * around the origin, and scaled by a power of two to about [-1, 1]. The
+ * frame is only used when moving the points into it is exact (which it is
+ * unless the coordinates span very different magnitudes), so the exact
+ * predicates give the same answers in it, and the points are moved back
+ * afterwards. What it changes are the tests of the sweep which use an
+ * absolute tolerance (EPSILON): in the frame they do not depend on the
+ * scale and the position of the input, so that very small inputs can be
+ * triangulated. It is off by default
+ *
+ * @param normalize
+ */
+void p2t_cdt_set_normalize (P2tCDT *THIS, gboolean normalize);
+
 /**
  * Triangulate - do this AFTER you've added the polyline, holes, and Steiner points
  */
 void p2t_cdt_triangulate (P2tCDT *THIS);
 
+/**
+ * Insert a Steiner point into the triangulation - do this AFTER
+ * p2t_cdt_triangulate. Only the triangles around the point change, and
+ * the triangulation stays constrained Delaunay. The point gets the next
+ * point index
+ *
+ * @param point
+ * @param hint A triangle near the point (for example the one returned by
+ *             the previous insertion), or NULL. Finding the point starts
+ *             there
+ * @return A triangle which has @point as a vertex, or NULL if the point is
+ *         outside the triangulation or is already one of its points
+ */
+P2tTriangle* p2t_cdt_insert_point (P2tCDT *THIS, P2tPoint *point, P2tTriangle *hint);
+
+/**
+ * Insert a hole into the triangulation - do this AFTER p2t_cdt_triangulate.
+ * Only the triangles around and inside the hole change. The triangles
+ * inside it are removed from p2t_cdt_get_triangles (but stay in the map),
+ * and the last triangles of p2t_cdt_get_triangles take their places. A
+ * hole or a Steiner point which is inside the new hole (without touching
+ * it) is merged into it, and its points are left out of the triangles
+ *
+ * @param polyline A simple polygon with non repeating points
+ * @return FALSE, without changing anything, if the hole is not strictly
+ *         inside the triangulation (touching its boundary, another hole or
+ *         a point)
+ */
+gboolean p2t_cdt_insert_hole (P2tCDT *THIS, P2tPointPtrArray polyline);
+
 /**
  * Get CDT triangles
  */
 P2tTrianglePtrArray p2t_cdt_get_triangles (P2tCDT *THIS);
 
 /**
- * Get triangle map
+ * Get the amount of input points - the polyline, the holes and the
+ * Steiner points, in the order they were added
+ */
+guint p2t_cdt_get_point_count (P2tCDT *THIS);
+
+/**
+ * Get the CDT triangles as an index buffer, with no per-point lookups
+ *
+ * @param xy Filled with the coordinates of the input points in the order
+ *           they were added, as x0, y0, x1, y1, ... Must have room for
+ *           2 * p2t_cdt_get_point_count () values. May be NULL
+ * @param indices Filled with three point indices (into @xy) per triangle,
+ *                in the order of p2t_cdt_get_triangles (). Must have room
+ *                for 3 * p2t_cdt_get_triangles ()->len values
+ *
+ * Call this only AFTER p2t_cdt_triangulate.
+ */
+void p2t_cdt_get_indexed (P2tCDT *THIS, double *xy, guint32 *indices);
+
+/**
+ * Get triangle map - all the triangles created during the sweep,
+ * including the ones outside the polygon. Iterate it with
+ * triangle_index (map, i) for i < map->len. The array is owned by the
+ * CDT, and its order is not meaningful.
  */
-P2tTrianglePtrList p2t_cdt_get_map (P2tCDT *THIS);
+P2tTrianglePtrArray p2t_cdt_get_map (P2tCDT *THIS);
 
 #endif
@@ -0,0 +1,791 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <glib.h>
+
+#include "insert.h"
+#include "sweep.h"
+#include "sweep_context.h"
+#include "../common/predicates.h"
+
+#define P2T_ORIENT(a,b,c) p2t_predicates_orient2d ((a)->x, (a)->y, (b)->x, (b)->y, (c)->x, (c)->y)
+
+/* A vertex on one side of the cavity of a new constraint edge */
+typedef struct
+{
+  P2tPoint    *point;
+  /* The triangle outside the cavity across the edge from this vertex to
+   * the next one of the side, and whether that edge is a constraint */
+  P2tTriangle *outside;
+  gboolean     constrained;
+} P2tInsertVertex;
+
+/* A piece of the cavity, between the vertices lo and hi of a side */
+typedef struct
+{
+  guint        lo, hi;
+  /* The triangle on the other side of the edge from lo to hi, NULL if it
+   * was not made yet */
+  P2tTriangle *below;
+} P2tInsertFrame;
+
+/* A vertex which a side of the cavity goes to and back from, along the
+ * edge from base to it */
+typedef struct
+{
+  P2tPoint    *point;
+  P2tPoint    *base;
+  gboolean     constrained;
+} P2tInsertPendant;
+
+void
+p2t_insert_init (P2tInsert *THIS)
+{
+  THIS->flip_stack_ = g_ptr_array_new ();
+  THIS->cavity_ = g_ptr_array_new ();
+  THIS->right_ = g_array_new (FALSE, FALSE, sizeof (P2tInsertVertex));
+  THIS->left_ = g_array_new (FALSE, FALSE, sizeof (P2tInsertVertex));
+  THIS->frames_ = g_array_new (FALSE, FALSE, sizeof (P2tInsertFrame));
+  THIS->pendants_ = g_array_new (FALSE, FALSE, sizeof (P2tInsertPendant));
+}
+
+void
+p2t_insert_destroy (P2tInsert *THIS)
+{
+  g_ptr_array_free (THIS->flip_stack_, TRUE);
+  g_ptr_array_free (THIS->cavity_, TRUE);
+  g_array_free (THIS->right_, TRUE);
+  g_array_free (THIS->left_, TRUE);
+  g_array_free (THIS->frames_, TRUE);
+  g_array_free (THIS->pendants_, TRUE);
+}
+
+/* The orientation of the point relative to the edge of the triangle which
+ * is opposite to its j'th point (positive on the side of the triangle) */
+static double
+p2t_insert_side (P2tTriangle *t, int j, P2tPoint *p)
+{
+  return P2T_ORIENT (p2t_triangle_get_point (t, (j + 1) % 3), p2t_triangle_get_point (t, (j + 2) % 3), p);
+}
+
+static gboolean
+p2t_insert_contains (P2tTriangle *t, P2tPoint *p)
+{
+  return p2t_insert_side (t, 0, p) >= 0 && p2t_insert_side (t, 1, p) >= 0 && p2t_insert_side (t, 2, p) >= 0;
+}
+
+/* Is d strictly inside the circumcircle of a, b and c (in any order)? */
+static gboolean
+p2t_insert_in_circle (P2tPoint *a, P2tPoint *b, P2tPoint *c, P2tPoint *d)
+{
+  if (P2T_ORIENT (a, b, c) < 0)
+    {
+      P2tPoint *tmp = a;
+      a = b;
+      b = tmp;
+    }
+  return p2t_predicates_incircle (a->x, a->y, b->x, b->y, c->x, c->y, d->x, d->y) > 0;
+}
+
+P2tTriangle*
+p2t_insert_locate (P2tSweepContext *tcx, P2tPoint *point, P2tTriangle *hint)
+{
+  P2tTrianglePtrArray triangles = p2t_sweepcontext_get_triangles (tcx);
+  P2tTriangle *t = hint;
+  guint steps, i;
+
+  if (triangles->len == 0)
+    return NULL;
+  if (t == NULL || ! p2t_triangle_is_interior (t))
+    t = triangle_index (triangles, triangles->len - 1);
+
+  /* Cross the first edge which has the point on its other side. Starting
+   * the tests from another edge at every step keeps the walk from going
+   * around in circles in a triangulation which is not Delaunay */
+  for (steps = 0; steps < triangles->len; steps++)
+    {
+      P2tTriangle *next = NULL;
+      int k;
+
+      for (k = 0; k < 3; k++)
+        {
+          int j = (k + steps) % 3;
+          if (p2t_insert_side (t, j, point) < 0)
+            {
+              next = p2t_triangle_get_neighbor (t, j);
+              break;
+            }
+        }
+
+      if (k == 3)
+        return t;
+      if (next == NULL || ! p2t_triangle_is_interior (next))
+        break;
+      t = next;
+    }
+
+  for (i = 0; i < triangles->len; i++)
+    if (p2t_insert_contains (triangle_index (triangles, i), point))
+      return triangle_index (triangles, i);
+  return NULL;
+}
+
+/* Give a triangle new points, dropping its neighbours and its flags but
+ * keeping its place in the map and in the result */
+static void
+p2t_insert_set_points (P2tTriangle *t, P2tPoint *a, P2tPoint *b, P2tPoint *c)
+{
+  guint map_index = t->map_index_;
+  guint result_index = t->result_index_;
+  gboolean interior = p2t_triangle_is_interior (t);
+
+  p2t_triangle_init (t, a, b, c);
+  t->map_index_ = map_index;
+  t->result_index_ = result_index;
+  p2t_triangle_is_interior_b (t, interior);
+}
+
+/* Make a triangle for a split. The triangles of a cavity which were left
+ * over for its pendant vertices are used first */
+static P2tTriangle*
+p2t_insert_new_triangle (P2tInsert *THIS, P2tSweepContext *tcx, P2tPoint *a, P2tPoint *b, P2tPoint *c, gboolean interior)
+{
+  P2tTriangle *t;
+
+  if (interior && THIS->cavity_->len > 0)
+    {
+      t = triangle_index (THIS->cavity_, THIS->cavity_->len - 1);
+      g_ptr_array_set_size (THIS->cavity_, THIS->cavity_->len - 1);
+      p2t_insert_set_points (t, a, b, c);
+      return t;
+    }
+
+  t = p2t_sweepcontext_new_triangle (tcx, a, b, c);
+  p2t_sweepcontext_add_to_map (tcx, t);
+  if (interior)
+    {
+      p2t_triangle_is_interior_b (t, TRUE);
+      p2t_sweepcontext_add_to_result (tcx, t);
+    }
+  return t;
+}
+
+static void
+p2t_insert_link (P2tTriangle *t, P2tTriangle *ot)
+{
+  if (ot != NULL)
+    p2t_triangle_mark_neighbor_tr (t, ot);
+}
+
+/* Split a triangle into three around a point inside it */
+static void
+p2t_insert_split_triangle (P2tInsert *THIS, P2tSweepContext *tcx, P2tTriangle *t, P2tPoint *point)
+{
+  P2tPoint *p0 = p2t_triangle_get_point (t, 0);
+  P2tPoint *p1 = p2t_triangle_get_point (t, 1);
+  P2tPoint *p2 = p2t_triangle_get_point (t, 2);
+  P2tTriangle *n0 = p2t_triangle_get_neighbor (t, 0);
+  P2tTriangle *n1 = p2t_triangle_get_neighbor (t, 1);
+  P2tTriangle *n2 = p2t_triangle_get_neighbor (t, 2);
+  gboolean c0 = p2t_triangle_get_constrained_edge (t, 0);
+  gboolean c1 = p2t_triangle_get_constrained_edge (t, 1);
+  gboolean c2 = p2t_triangle_get_constrained_edge (t, 2);
+  P2tTriangle *t1, *t2;
+
+  p2t_insert_set_points (t, point, p1, p2);
+  t1 = p2t_insert_new_triangle (THIS, tcx, p0, point, p2, TRUE);
+  t2 = p2t_insert_new_triangle (THIS, tcx, p0, p1, point, TRUE);
+
+  /* Each piece keeps one edge of the triangle, opposite to the point */
+  p2t_triangle_set_constrained_edge (t, 0, c0);
+  p2t_triangle_set_constrained_edge (t1, 1, c1);
+  p2t_triangle_set_constrained_edge (t2, 2, c2);
+  p2t_insert_link (t, n0);
+  p2t_insert_link (t1, n1);
+  p2t_insert_link (t2, n2);
+  p2t_triangle_mark_neighbor_tr (t, t1);
+  p2t_triangle_mark_neighbor_tr (t1, t2);
+  p2t_triangle_mark_neighbor_tr (t2, t);
+
+  g_ptr_array_add (THIS->flip_stack_, t);
+  g_ptr_array_add (THIS->flip_stack_, t1);
+  g_ptr_array_add (THIS->flip_stack_, t2);
+}
+
+/* Split the edge of a triangle which is opposite to its j'th point, and
+ * the triangle on the other side of it, at a point on that edge */
+static void
+p2t_insert_split_edge (P2tInsert *THIS, P2tSweepContext *tcx, P2tTriangle *t, int j, P2tPoint *point)
+{
+  P2tPoint *pj = p2t_triangle_get_point (t, j);
+  P2tPoint *a = p2t_triangle_get_point (t, (j + 1) % 3);
+  P2tPoint *b = p2t_triangle_get_point (t, (j + 2) % 3);
+  P2tTriangle *na = p2t_triangle_get_neighbor (t, (j + 1) % 3);
+  P2tTriangle *nb = p2t_triangle_get_neighbor (t, (j + 2) % 3);
+  gboolean ca = p2t_triangle_get_constrained_edge (t, (j + 1) % 3);
+  gboolean cb = p2t_triangle_get_constrained_edge (t, (j + 2) % 3);
+  gboolean cs = p2t_triangle_get_constrained_edge (t, j);
+  P2tTriangle *ot = p2t_triangle_get_neighbor (t, j);
+  P2tTriangle *t2, *ot2 = NULL;
+
+  /* t = (pj, a, b) becomes (pj, a, point) and (pj, point, b) */
+  if (ot != NULL)
+    {
+      /* ot = (q, b, a) becomes (q, b, point) and (q, point, a) */
+      P2tPoint *q = p2t_triangle_opposite_point (ot, t, pj);
+      P2tTriangle *ona = p2t_triangle_neighbor_across (ot, a);
+      P2tTriangle *onb = p2t_triangle_neighbor_across (ot, b);
+      gboolean oca = p2t_triangle_get_constrained_edge (ot, p2t_triangle_index (ot, a));
+      gboolean ocb = p2t_triangle_get_constrained_edge (ot, p2t_triangle_index (ot, b));
+
+      p2t_insert_set_points (ot, q, b, point);
+      ot2 = p2t_insert_new_triangle (THIS, tcx, q, point, a, p2t_triangle_is_interior (ot));
+      p2t_triangle_set_constrained_edge (ot, 0, cs);
+      p2t_triangle_set_constrained_edge (ot, 2, oca);
+      p2t_triangle_set_constrained_edge (ot2, 0, cs);
+      p2t_triangle_set_constrained_edge (ot2, 1, ocb);
+      p2t_insert_link (ot, ona);
+      p2t_insert_link (ot2, onb);
+      p2t_triangle_mark_neighbor_tr (ot, ot2);
+
+      /* The triangles outside the domain need no flips */
+      if (p2t_triangle_is_interior (ot))
+        {
+          g_ptr_array_add (THIS->flip_stack_, ot);
+          g_ptr_array_add (THIS->flip_stack_, ot2);
+        }
+    }
+
+  p2t_insert_set_points (t, pj, a, point);
+  t2 = p2t_insert_new_triangle (THIS, tcx, pj, point, b, TRUE);
+  p2t_triangle_set_constrained_edge (t, 0, cs);
+  p2t_triangle_set_constrained_edge (t, 2, cb);
+  p2t_triangle_set_constrained_edge (t2, 0, cs);
+  p2t_triangle_set_constrained_edge (t2, 1, ca);
+  p2t_insert_link (t, nb);
+  p2t_insert_link (t2, na);
+  p2t_triangle_mark_neighbor_tr (t, t2);
+  if (ot != NULL)
+    {
+      p2t_triangle_mark_neighbor_tr (t, ot2);
+      p2t_triangle_mark_neighbor_tr (t2, ot);
+    }
+
+  g_ptr_array_add (THIS->flip_stack_, t);
+  g_ptr_array_add (THIS->flip_stack_, t2);
+}
+
+/* Flip the edges in front of a new point until they are all (constrained)
+ * Delaunay. Every triangle on the stack has the point as a vertex */
+static void
+p2t_insert_legalize (P2tInsert *THIS, P2tSweep *sweep, P2tPoint *point)
+{
+  GPtrArray *stack = THIS->flip_stack_;
+
+  while (stack->len > 0)
+    {
+      P2tTriangle *t = triangle_index (stack, stack->len - 1);
+      int i = p2t_triangle_index (t, point);
+      P2tTriangle *ot = p2t_triangle_get_neighbor (t, i);
+      P2tPoint *op;
+
+      g_ptr_array_set_size (stack, stack->len - 1);
+      if (ot == NULL || p2t_triangle_get_constrained_edge (t, i) || ! p2t_triangle_is_interior (ot))
+        continue;
+
+      op = p2t_triangle_opposite_point (ot, t, point);
+      if (p2t_sweep_incircle (sweep, point, p2t_triangle_point_ccw (t, point), p2t_triangle_point_cw (t, point), op))
+        {
+          /* Both triangles still have the point, and each has a new edge
+           * in front of it */
+          p2t_sweep_rotate_triangle_pair (sweep, t, point, ot, op);
+          g_ptr_array_add (stack, t);
+          g_ptr_array_add (stack, ot);
+        }
+    }
+}
+
+/* The edge of a triangle containing a point which the point lies on: -1
+ * if it is inside the triangle, and -2 if it is one of its vertices */
+static int
+p2t_insert_find_edge (P2tTriangle *t, P2tPoint *point)
+{
+  int j, edge = -1;
+
+  for (j = 0; j < 3; j++)
+    if (p2t_insert_side (t, j, point) == 0)
+      {
+        /* On two edges means on the vertex between them */
+        if (edge != -1)
+          return -2;
+        edge = j;
+      }
+  return edge;
+}
+
+/* Split the triangle containing a point (or the two triangles on the
+ * edge which it lies on) at the point, and make the triangulation
+ * constrained Delaunay again */
+static void
+p2t_insert_split (P2tInsert *THIS, P2tSweep *sweep, P2tSweepContext *tcx, P2tTriangle *t, int edge, P2tPoint *point)
+{
+  g_ptr_array_set_size (THIS->flip_stack_, 0);
+  if (edge == -1)
+    p2t_insert_split_triangle (THIS, tcx, t, point);
+  else
+    p2t_insert_split_edge (THIS, tcx, t, edge, point);
+  p2t_insert_legalize (THIS, sweep, point);
+}
+
+P2tTriangle*
+p2t_insert_point (P2tInsert *THIS, P2tSweep *sweep, P2tSweepContext *tcx, P2tPoint *point, P2tTriangle *hint)
+{
+  P2tTriangle *t = p2t_insert_locate (tcx, point, hint);
+  int edge;
+
+  if (t == NULL)
+    return NULL;
+
+  edge = p2t_insert_find_edge (t, point);
+  if (edge == -2)
+    return NULL;
+
+  p2t_sweepcontext_add_point (tcx, point);
+  p2t_insert_split (THIS, sweep, tcx, t, edge, point);
+
+  return t;
+}
+
+/* Locate a vertex of a new hole, which must be strictly inside the domain,
+ * away from the constraint edges, and must not be a vertex already */
+static P2tTriangle*
+p2t_insert_locate_free (P2tSweepContext *tcx, P2tPoint *point, P2tTriangle *hint)
+{
+  P2tTriangle *t = p2t_insert_locate (tcx, point, hint);
+  int j, edges = 0;
+
+  if (t == NULL)
+    return NULL;
+
+  for (j = 0; j < 3; j++)
+    if (p2t_insert_side (t, j, point) == 0)
+      {
+        if (p2t_triangle_get_constrained_edge (t, j) || p2t_triangle_get_neighbor (t, j) == NULL)
+          return NULL;
+        edges++;
+      }
+
+  return edges < 2 ? t : NULL;
+}
+
+/* Can the edge from s (inside the triangle t, or on its boundary) to e be
+ * added without crossing or touching a constraint edge or a vertex? */
+static gboolean
+p2t_insert_segment_is_free (P2tTriangle *t, P2tPoint *s, P2tPoint *e)
+{
+  while (! p2t_insert_contains (t, e))
+    {
+      P2tTriangle *next = NULL;
+      int j;
+
+      /* Find the edge through which the segment leaves the triangle */
+      for (j = 0; j < 3; j++)
+        {
+          double oa, ob;
+
+          if (p2t_insert_side (t, j, e) >= 0)
+            continue;
+          oa = P2T_ORIENT (s, e, p2t_triangle_get_point (t, (j + 1) % 3));
+          ob = P2T_ORIENT (s, e, p2t_triangle_get_point (t, (j + 2) % 3));
+          if (oa > 0 || ob < 0)
+            continue;
+          if (oa == 0 || ob == 0 || p2t_triangle_get_constrained_edge (t, j))
+            return FALSE;
+          next = p2t_triangle_get_neighbor (t, j);
+          break;
+        }
+
+      if (next == NULL || ! p2t_triangle_is_interior (next))
+        return FALSE;
+      t = next;
+    }
+  return TRUE;
+}
+
+static void
+p2t_insert_add_vertex (GArray *side, P2tPoint *point, P2tTriangle *t, P2tPoint *opposite)
+{
+  P2tInsertVertex v;
+
+  v.point = point;
+  if (t != NULL)
+    {
+      v.outside = p2t_triangle_neighbor_across (t, opposite);
+      v.constrained = p2t_triangle_get_constrained_edge (t, p2t_triangle_index (t, opposite));
+    }
+  else
+    {
+      v.outside = NULL;
+      v.constrained = FALSE;
+    }
+  g_array_append_val (side, v);
+}
+
+#ifndef G_DISABLE_ASSERT
+/* Is every neighbour of the triangle linked back to it, across the same
+ * edge? */
+static gboolean
+p2t_insert_links_are_mutual (P2tTriangle *t)
+{
+  int j;
+
+  for (j = 0; j < 3; j++)
+    {
+      P2tTriangle *ot = p2t_triangle_get_neighbor (t, j);
+      P2tPoint *a = p2t_triangle_get_point (t, (j + 1) % 3);
+      P2tPoint *b = p2t_triangle_get_point (t, (j + 2) % 3);
+
+      if (ot != NULL && (! p2t_triangle_contains_pt_pt (ot, a, b)
+                         || p2t_triangle_neighbor_across (ot, p2t_triangle_opposite_point (ot, t, p2t_triangle_get_point (t, j))) != t))
+        return FALSE;
+    }
+  return TRUE;
+}
+#endif
+
+/* Triangulate the piece of the cavity between one of its sides and the new
+ * constraint edge, reusing the triangles of the cavity. Each triangle on an
+ * edge takes the vertex whose circumcircle with that edge is empty of the
+ * other vertices of the piece (Anglada's algorithm), which makes the
+ * result constrained Delaunay. The triangles made are also pushed on
+ * THIS->flip_stack_. Returns the triangle on the new edge */
+static P2tTriangle*
+p2t_insert_fill (P2tInsert *THIS, GArray *side, P2tTriangle *below)
+{
+  GArray *frames = THIS->frames_;
+  P2tTriangle *top = NULL;
+  P2tInsertFrame frame;
+
+  frame.lo = 0;
+  frame.hi = side->len - 1;
+  frame.below = below;
+  g_array_set_size (frames, 0);
+  g_array_append_val (frames, frame);
+
+  while (frames->len > 0)
+    {
+      P2tInsertFrame f = g_array_index (frames, P2tInsertFrame, frames->len - 1);
+      P2tPoint *a = g_array_index (side, P2tInsertVertex, f.lo).point;
+      P2tPoint *b = g_array_index (side, P2tInsertVertex, f.hi).point;
+      P2tPoint *c;
+      P2tTriangle *t;
+      guint k, m;
+
+      g_array_set_size (frames, frames->len - 1);
+
+      if (f.hi == f.lo + 1)
+        {
+          /* An edge of the cavity - attach the triangle outside it */
+          P2tInsertVertex *v = &g_array_index (side, P2tInsertVertex, f.lo);
+          p2t_insert_link (f.below, v->outside);
+          if (v->constrained)
+            p2t_triangle_mark_constrained_edge_pt_pt (f.below, a, b);
+          continue;
+        }
+
+      m = f.lo + 1;
+      for (k = f.lo + 2; k < f.hi; k++)
+        if (p2t_insert_in_circle (a, b, g_array_index (side, P2tInsertVertex, m).point, g_array_index (side, P2tInsertVertex, k).point))
+          m = k;
+      c = g_array_index (side, P2tInsertVertex, m).point;
+
+      t = triangle_index (THIS->cavity_, THIS->cavity_->len - 1);
+      g_ptr_array_set_size (THIS->cavity_, THIS->cavity_->len - 1);
+      if (P2T_ORIENT (a, b, c) > 0)
+        p2t_insert_set_points (t, a, b, c);
+      else
+        p2t_insert_set_points (t, b, a, c);
+
+      g_ptr_array_add (THIS->flip_stack_, t);
+      if (f.lo == 0 && f.hi == side->len - 1)
+        {
+          p2t_triangle_mark_constrained_edge_pt_pt (t, a, b);
+          top = t;
+        }
+      p2t_insert_link (t, f.below);
+
+      frame.below = t;
+      frame.lo = f.lo;
+      frame.hi = m;
+      g_array_append_val (frames, frame);
+      frame.lo = m;
+      frame.hi = f.hi;
+      g_array_append_val (frames, frame);
+    }
+
+  return top;
+}
+
+/* A side of the cavity is not a simple chain when the new edge passes so
+ * close to a vertex that all the triangles around it are crossed: the
+ * side then goes from a vertex u to that vertex and back to u, and the
+ * triangles outside both of these edges are in the cavity. Drop each such
+ * return from the side, and keep the vertex for later */
+static void
+p2t_insert_fold_pendants (GArray *side, GArray *pendants)
+{
+  guint k, w = 0;
+
+  for (k = 0; k < side->len; k++)
+    {
+      g_array_index (side, P2tInsertVertex, w++) = g_array_index (side, P2tInsertVertex, k);
+      while (w >= 3 && g_array_index (side, P2tInsertVertex, w - 1).point == g_array_index (side, P2tInsertVertex, w - 3).point)
+        {
+          P2tInsertPendant p;
+
+          p.point = g_array_index (side, P2tInsertVertex, w - 2).point;
+          p.base = g_array_index (side, P2tInsertVertex, w - 1).point;
+          p.constrained = g_array_index (side, P2tInsertVertex, w - 3).constrained
+              || g_array_index (side, P2tInsertVertex, w - 2).constrained;
+          g_array_append_val (pendants, p);
+
+          g_array_index (side, P2tInsertVertex, w - 3) = g_array_index (side, P2tInsertVertex, w - 1);
+          w -= 2;
+        }
+    }
+  g_array_set_size (side, w);
+}
+
+/* Make the edge from s to e a constraint edge, given a triangle which has
+ * s as a vertex. The triangles crossed by the edge are triangulated again */
+static void
+p2t_insert_recover_edge (P2tInsert *THIS, P2tSweep *sweep, P2tSweepContext *tcx, P2tTriangle *t, P2tPoint *s, P2tPoint *e)
+{
+  P2tPoint *r, *l, *apex;
+  P2tTriangle *right;
+  guint first = THIS->pendants_->len, k;
+
+  /* Turn counter-clockwise around s, to the triangle through which the
+   * edge leaves it */
+  for (;;)
+    {
+      int i = p2t_triangle_index (t, s);
+      P2tPoint *a = p2t_triangle_get_point (t, (i + 1) % 3);
+      P2tPoint *b = p2t_triangle_get_point (t, (i + 2) % 3);
+
+      if (a == e || b == e)
+        {
+          /* The edge is already there */
+          P2tTriangle *ot = p2t_triangle_neighbor_across (t, a == e ? b : a);
+          p2t_triangle_mark_constrained_edge_pt_pt (t, s, e);
+          if (ot != NULL)
+            p2t_triangle_mark_constrained_edge_pt_pt (ot, s, e);
+          return;
+        }
+      if (P2T_ORIENT (s, a, e) > 0 && P2T_ORIENT (s, b, e) < 0)
+        {
+          r = a;
+          l = b;
+          break;
+        }
+      t = p2t_triangle_get_neighbor (t, (i + 1) % 3);
+      g_return_if_fail (t != NULL);
+    }
+
+  /* Walk along the edge, collecting the crossed triangles and the
+   * vertices on both of its sides */
+  g_ptr_array_set_size (THIS->cavity_, 0);
+  g_array_set_size (THIS->right_, 0);
+  g_array_set_size (THIS->left_, 0);
+  p2t_insert_add_vertex (THIS->right_, s, t, l);
+  p2t_insert_add_vertex (THIS->left_, s, t, r);
+  g_ptr_array_add (THIS->cavity_, t);
+  apex = s;
+
+  for (;;)
+    {
+      P2tTriangle *ot = p2t_triangle_neighbor_across (t, apex);
+      P2tPoint *c = p2t_triangle_opposite_point (ot, t, apex);
+
+      g_ptr_array_add (THIS->cavity_, ot);
+      if (c == e)
+        {
+          p2t_insert_add_vertex (THIS->right_, r, ot, l);
+          p2t_insert_add_vertex (THIS->left_, l, ot, r);
+          p2t_insert_add_vertex (THIS->right_, e, NULL, NULL);
+          p2t_insert_add_vertex (THIS->left_, e, NULL, NULL);
+          break;
+        }
+      else if (P2T_ORIENT (s, e, c) < 0)
+        {
+          p2t_insert_add_vertex (THIS->right_, r, ot, l);
+          apex = r;
+          r = c;
+        }
+      else
+        {
+          p2t_insert_add_vertex (THIS->left_, l, ot, r);
+          apex = l;
+          l = c;
+        }
+      t = ot;
+    }
+
+  p2t_insert_fold_pendants (THIS->right_, THIS->pendants_);
+  p2t_insert_fold_pendants (THIS->left_, THIS->pendants_);
+  g_ptr_array_set_size (THIS->flip_stack_, 0);
+  right = p2t_insert_fill (THIS, THIS->right_, NULL);
+  p2t_insert_fill (THIS, THIS->left_, right);
+
+#ifndef G_DISABLE_ASSERT
+  for (k = 0; k < THIS->flip_stack_->len; k++)
+    g_assert (p2t_insert_links_are_mutual (triangle_index (THIS->flip_stack_, k)));
+#endif
+
+  /* The pendant vertices are inside the filled cavity. Each of them takes
+   * two of the triangles which the fill left over */
+  for (k = first; k < THIS->pendants_->len; k++)
+    {
+      P2tPoint *p = g_array_index (THIS->pendants_, P2tInsertPendant, k).point;
+
+      t = p2t_insert_locate (tcx, p, right);
+      p2t_insert_split (THIS, sweep, tcx, t, p2t_insert_find_edge (t, p), p);
+    }
+  g_assert (THIS->cavity_->len == 0);
+
+  /* Their edges which were constraint edges are recovered last, as that
+   * uses the work storage again */
+  while (THIS->pendants_->len > first)
+    {
+      P2tInsertPendant p = g_array_index (THIS->pendants_, P2tInsertPendant, THIS->pendants_->len - 1);
+
+      g_array_set_size (THIS->pendants_, THIS->pendants_->len - 1);
+      if (p.constrained)
+        p2t_insert_recover_edge (THIS, sweep, tcx, p2t_insert_locate (tcx, p.point, right), p.point, p.base);
+    }
+}
+
+P2tTriangle*
+p2t_insert_edge (P2tInsert *THIS, P2tSweep *sweep, P2tSweepContext *tcx, P2tPoint *p, P2tPoint *q, P2tTriangle *hint)
+{
+  P2tTriangle *t = p2t_insert_locate (tcx, p, hint), *start = t;
+
+  g_return_val_if_fail (t != NULL, NULL);
+
+  /* The recovery turns counter-clockwise around p, so start it from the
+   * last triangle clockwise in case p is on the boundary */
+  for (;;)
+    {
+      P2tTriangle *next = p2t_triangle_get_neighbor (t, (p2t_triangle_index (t, p) + 2) % 3);
+      if (next == NULL || next == start || ! p2t_triangle_is_interior (next))
+        break;
+      t = next;
+    }
+
+  p2t_insert_recover_edge (THIS, sweep, tcx, t, p, q);
+  return t;
+}
+
+gboolean
+p2t_insert_hole (P2tInsert *THIS, P2tSweep *sweep, P2tSweepContext *tcx, P2tPointPtrArray polyline)
+{
+  GPtrArray *stack = THIS->flip_stack_;
+  P2tTriangle *t = NULL;
+  double area = 0;
+  guint i, n = polyline->len;
+
+  if (n < 3)
+    return FALSE;
+
+  /* Check everything before changing anything */
+  for (i = 0; i < n; i++)
+    {
+      P2tPoint *p = point_index (polyline, i);
+      P2tPoint *q = point_index (polyline, (i + 1) % n);
+
+      t = p2t_insert_locate_free (tcx, p, t);
+      if (t == NULL || ! p2t_insert_segment_is_free (t, p, q))
+        return FALSE;
+      area += p->x * q->y - q->x * p->y;
+    }
+
+  for (i = 0; i < n; i++)
+    t = p2t_insert_point (THIS, sweep, tcx, point_index (polyline, i), t);
+
+  for (i = 0; i < n; i++)
+    {
+      P2tPoint *p = point_index (polyline, i);
+      t = p2t_insert_locate (tcx, p, t);
+      p2t_insert_recover_edge (THIS, sweep, tcx, t, p, point_index (polyline, (i + 1) % n));
+    }
+
+  /* Find the triangle inside the hole on its first edge - on the left of
+   * the edge if the hole is counter-clockwise, on the right otherwise */
+  t = p2t_insert_locate (tcx, point_index (polyline, 0), t);
+  for (;;)
+    {
+      int j = p2t_triangle_index (t, point_index (polyline, 0));
+      if (p2t_triangle_get_point (t, area > 0 ? (j + 1) % 3 : (j + 2) % 3) == point_index (polyline, 1))
+        break;
+      t = p2t_triangle_get_neighbor (t, (j + 1) % 3);
+    }
+
+  /* Flood the hole up to its constraint edges, and drop the flooded
+   * triangles from the result - each from its own slot, so that the cost
+   * depends only on the size of the hole */
+  g_ptr_array_set_size (stack, 0);
+  p2t_triangle_is_interior_b (t, FALSE);
+  p2t_sweepcontext_remove_from_result (tcx, t);
+  g_ptr_array_add (stack, t);
+  while (stack->len > 0)
+    {
+      int j;
+
+      t = triangle_index (stack, stack->len - 1);
+      g_ptr_array_set_size (stack, stack->len - 1);
+      for (j = 0; j < 3; j++)
+        {
+          P2tTriangle *ot = p2t_triangle_get_neighbor (t, j);
+          if (! p2t_triangle_get_constrained_edge (t, j) && ot != NULL && p2t_triangle_is_interior (ot))
+            {
+              p2t_triangle_is_interior_b (ot, FALSE);
+              p2t_sweepcontext_remove_from_result (tcx, ot);
+              g_ptr_array_add (stack, ot);
+            }
+        }
+    }
+
+  return TRUE;
+}
@@ -0,0 +1,135 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __P2TC_P2T_INSERT_H__
+#define __P2TC_P2T_INSERT_H__
+
+#include "../common/poly2tri-private.h"
+#include "../common/shapes.h"
+
+/**
+ * Editing a triangulation after the sweep - inserting Steiner points and
+ * holes by changing only the triangles around them. The work storage is
+ * kept from one edit to the next
+ */
+struct _P2tInsert
+{
+  /*< private >*/
+  /* The triangles whose edges have to be checked after an insertion */
+  GPtrArray *flip_stack_;
+  /* The triangles crossed by a new constraint edge, which are reused for
+   * the triangles of the cavity */
+  GPtrArray *cavity_;
+  /* The vertices of the cavity to the right and to the left of the new
+   * constraint edge */
+  GArray *right_;
+  GArray *left_;
+  /* The pending pieces of the cavity to triangulate */
+  GArray *frames_;
+  /* The vertices which a new constraint edge passes so close to that all
+   * their triangles are in the cavity. They are left out of the cavity,
+   * and inserted again after it is triangulated */
+  GArray *pendants_;
+};
+
+void p2t_insert_init (P2tInsert *THIS);
+void p2t_insert_destroy (P2tInsert *THIS);
+
+/**
+ * Find the interior triangle containing a point (on its boundary counts),
+ * walking towards the point from a triangle close to it. The walk can not
+ * leave the triangulated domain, so when the straight way is blocked (by a
+ * hole or a concave part of the boundary) all the triangles are searched
+ *
+ * @param tcx A triangulated sweep context
+ * @param point
+ * @param hint The triangle to start from, or NULL to start from the last
+ *             triangle of the result
+ * @return The triangle, or NULL if the point is outside the domain
+ */
+P2tTriangle* p2t_insert_locate (P2tSweepContext *tcx, P2tPoint *point, P2tTriangle *hint);
+
+/**
+ * Insert a Steiner point into a triangulated sweep context: the triangle
+ * (or the two triangles, if the point lies on an edge) containing the
+ * point are split, and the new edges are flipped until the triangulation
+ * is constrained Delaunay again. A constraint edge through the point is
+ * split into two constraint edges. The point is added to the points of the
+ * context, with the next index
+ *
+ * @param sweep The sweep whose flips are used
+ * @param tcx
+ * @param point
+ * @param hint See #p2t_insert_locate
+ * @return A triangle which has @point as a vertex, or NULL if the point is
+ *         outside the domain or is already a vertex
+ */
+P2tTriangle* p2t_insert_point (P2tInsert *THIS, P2tSweep *sweep, P2tSweepContext *tcx, P2tPoint *point, P2tTriangle *hint);
+
+/**
+ * Insert a hole into a triangulated sweep context. Its vertices are
+ * inserted as points, its edges are made constraint edges by
+ * triangulating again only the triangles which they cross, and the
+ * triangles inside it are removed from the result (they stay in the map)
+ *
+ * Holes and Steiner points which were added before and lie inside the new
+ * hole are not rejected: they are merged into it, and the points inside it
+ * are left out of the result (they stay in the points of the context)
+ *
+ * @param sweep
+ * @param tcx
+ * @param polyline A simple polygon, strictly inside the domain - it may not
+ *                 touch the boundary, other holes or constraint edges
+ * @return FALSE (with the triangulation unchanged) if the hole is not
+ *         strictly inside the domain
+ */
+gboolean p2t_insert_hole (P2tInsert *THIS, P2tSweep *sweep, P2tSweepContext *tcx, P2tPointPtrArray polyline);
+
+/**
+ * Make the edge between two vertices of a triangulated sweep context a
+ * constraint edge, by triangulating again only the triangles which it
+ * crosses. The triangulation stays constrained Delaunay
+ *
+ * @param sweep
+ * @param tcx
+ * @param p A vertex of the triangulation
+ * @param q Another vertex - the edge to it may not cross constraint edges,
+ *          or go through other vertices
+ * @param hint See #p2t_insert_locate
+ * @return A triangle close to p, to use as the hint of the next edge
+ */
+P2tTriangle* p2t_insert_edge (P2tInsert *THIS, P2tSweep *sweep, P2tSweepContext *tcx, P2tPoint *p, P2tPoint *q, P2tTriangle *hint);
+
+#endif
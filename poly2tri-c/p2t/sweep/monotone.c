@@ -0,0 +1,396 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <glib.h>
+
+#include "monotone.h"
+#include "sweep.h"
+#include "sweep_context.h"
+#include "../common/predicates.h"
+
+#define P2T_ORIENT(a,b,c) p2t_predicates_orient2d ((a)->x, (a)->y, (b)->x, (b)->y, (c)->x, (c)->y)
+
+/* A vertex waiting on the stack of p2t_monotone_triangulate */
+typedef struct
+{
+  P2tPoint    *point;
+  /* +1 on the chain following the polygon order from the lowest point,
+   * -1 on the other one */
+  gint         chain;
+  /* The triangle below the edge from the previous vertex of the stack,
+   * NULL if that edge is a polygon edge */
+  P2tTriangle *below;
+} P2tMonotoneVertex;
+
+/* A vertex of the shrinking polygon of p2t_monotone_triangulate_convex */
+typedef struct
+{
+  /* The counter-clockwise neighbours, as they were when the vertex was
+   * removed */
+  guint        prev, next;
+  /* The triangle on the polygon edge from this vertex to the next one */
+  P2tTriangle *boundary;
+} P2tMonotoneLink;
+
+void
+p2t_monotone_init (P2tMonotone *THIS)
+{
+  THIS->stack_ = g_array_new (FALSE, FALSE, sizeof (P2tMonotoneVertex));
+  THIS->links_ = g_array_new (FALSE, FALSE, sizeof (P2tMonotoneLink));
+  THIS->order_ = g_array_new (FALSE, FALSE, sizeof (guint));
+  THIS->flip_stack_ = g_ptr_array_new ();
+}
+
+void
+p2t_monotone_destroy (P2tMonotone *THIS)
+{
+  g_array_free (THIS->stack_, TRUE);
+  g_array_free (THIS->links_, TRUE);
+  g_array_free (THIS->order_, TRUE);
+  g_ptr_array_free (THIS->flip_stack_, TRUE);
+}
+
+/* Does @a come before @b in the sweep order? */
+static gboolean
+p2t_monotone_before (const P2tPoint *a, const P2tPoint *b)
+{
+  return a->y < b->y || (a->y == b->y && a->x < b->x);
+}
+
+P2tMonotoneShape
+p2t_monotone_classify (P2tPointPtrArray polygon)
+{
+  guint n = polygon->len, n_minima = 0, n_ccw = 0, i;
+  P2tPoint *prev, *p;
+
+  if (n < 3)
+    return P2T_MONOTONE_SHAPE_OTHER;
+
+  prev = point_index (polygon, n - 2);
+  p = point_index (polygon, n - 1);
+  for (i = 0; i < n; i++)
+    {
+      P2tPoint *next = point_index (polygon, i);
+      double o = P2T_ORIENT (prev, p, next);
+
+      /* Collinear points could end up in degenerate triangles */
+      if (o == 0)
+        return P2T_MONOTONE_SHAPE_OTHER;
+      if (o > 0)
+        n_ccw++;
+
+      /* A polygon is monotone if it has only one local minimum */
+      if (p2t_monotone_before (p, prev) && p2t_monotone_before (p, next))
+        n_minima++;
+
+      prev = p;
+      p = next;
+    }
+
+  if (n_minima != 1)
+    return P2T_MONOTONE_SHAPE_OTHER;
+
+  /* Turning always the same way is not enough (think of a star), but
+   * together with being monotone it means convex */
+  return (n_ccw == 0 || n_ccw == n) ? P2T_MONOTONE_SHAPE_CONVEX : P2T_MONOTONE_SHAPE_MONOTONE;
+}
+
+/* Add a triangle to the result, in the counter-clockwise order of the
+ * triangles of the sweep */
+static P2tTriangle*
+p2t_monotone_add_triangle (P2tSweepContext *tcx, P2tPoint *a, P2tPoint *b, P2tPoint *c)
+{
+  P2tTriangle *t;
+
+  if (P2T_ORIENT (a, b, c) > 0)
+    t = p2t_sweepcontext_new_triangle (tcx, a, b, c);
+  else
+    t = p2t_sweepcontext_new_triangle (tcx, a, c, b);
+
+  p2t_triangle_is_interior_b (t, TRUE);
+  p2t_sweepcontext_add_to_map (tcx, t);
+  p2t_sweepcontext_add_to_result (tcx, t);
+  return t;
+}
+
+static void
+p2t_monotone_link (P2tTriangle *t, P2tTriangle *ot)
+{
+  if (ot != NULL)
+    p2t_triangle_mark_neighbor_tr (t, ot);
+}
+
+/* Every diagonal was linked to the triangles on both of its sides, so the
+ * edges without a neighbor are the edges of the polygon */
+static void
+p2t_monotone_constrain_boundary (P2tSweepContext *tcx)
+{
+  P2tTrianglePtrArray triangles = p2t_sweepcontext_get_triangles (tcx);
+  guint i;
+  int j;
+
+  for (i = 0; i < triangles->len; i++)
+    {
+      P2tTriangle *t = triangle_index (triangles, i);
+      for (j = 0; j < 3; j++)
+        if (p2t_triangle_get_neighbor (t, j) == NULL)
+          p2t_triangle_set_constrained_edge (t, j, TRUE);
+    }
+}
+
+/* Remember the triangle of each polygon edge of @t. Flips move the polygon
+ * edges from one triangle to the other */
+static void
+p2t_monotone_set_boundary (P2tMonotoneLink *links, P2tTriangle *t)
+{
+  int j;
+
+  for (j = 0; j < 3; j++)
+    if (p2t_triangle_get_neighbor (t, j) == NULL)
+      links[p2t_triangle_get_point (t, (j + 1) % 3)->index_].boundary = t;
+}
+
+void
+p2t_monotone_triangulate_convex (P2tMonotone *THIS, P2tSweep *sweep, P2tSweepContext *tcx, P2tPointPtrArray polygon)
+{
+  guint n = polygon->len, step, i, v;
+  /* A fixed seed, so that cocircular points are always resolved the same */
+  guint32 state = 2463534242u;
+  P2tMonotoneLink *links;
+  guint *order;
+  P2tTriangle *t;
+  GPtrArray *stack = THIS->flip_stack_;
+
+  g_array_set_size (THIS->links_, n);
+  g_array_set_size (THIS->order_, n);
+  links = (P2tMonotoneLink*) THIS->links_->data;
+  order = (guint*) THIS->order_->data;
+
+  /* Walk the polygon counter-clockwise */
+  step = P2T_ORIENT (point_index (polygon, n - 1), point_index (polygon, 0), point_index (polygon, 1)) > 0 ? 1 : n - 1;
+  for (i = 0; i < n; i++)
+    {
+      links[i].next = (i + step) % n;
+      links[i].prev = (i + n - step) % n;
+      links[i].boundary = NULL;
+      order[i] = i;
+    }
+
+  for (i = n - 1; i > 0; i--)
+    {
+      guint j, tmp;
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      j = state % (i + 1);
+      tmp = order[i];
+      order[i] = order[j];
+      order[j] = tmp;
+    }
+
+  /* Remove all the vertices but three. Each keeps the neighbours it had,
+   * which are neighbours again when it is inserted back */
+  for (i = 0; i + 3 < n; i++)
+    {
+      v = order[i];
+      links[links[v].prev].next = links[v].next;
+      links[links[v].next].prev = links[v].prev;
+    }
+
+  v = order[n - 1];
+  t = p2t_monotone_add_triangle (tcx, point_index (polygon, v),
+                                 point_index (polygon, links[v].next),
+                                 point_index (polygon, links[links[v].next].next));
+  p2t_monotone_set_boundary (links, t);
+
+  /* Insert the vertices back. Each one only sees the polygon edge between
+   * its neighbours, so it makes one triangle with it, and then the edges
+   * in front of it are flipped until they are Delaunay */
+  for (i = n - 3; i > 0; i--)
+    {
+      P2tPoint *p;
+
+      v = order[i - 1];
+      p = point_index (polygon, v);
+      t = p2t_monotone_add_triangle (tcx, point_index (polygon, links[v].prev), p, point_index (polygon, links[v].next));
+      p2t_triangle_mark_neighbor_tr (t, links[links[v].prev].boundary);
+      p2t_monotone_set_boundary (links, t);
+
+      g_ptr_array_set_size (stack, 0);
+      g_ptr_array_add (stack, t);
+      while (stack->len > 0)
+        {
+          P2tTriangle *ot;
+          P2tPoint *op;
+
+          t = triangle_index (stack, stack->len - 1);
+          g_ptr_array_set_size (stack, stack->len - 1);
+
+          ot = p2t_triangle_neighbor_across (t, p);
+          if (ot == NULL)
+            continue;
+
+          op = p2t_triangle_opposite_point (ot, t, p);
+          if (p2t_sweep_incircle (sweep, p, p2t_triangle_point_ccw (t, p), p2t_triangle_point_cw (t, p), op))
+            {
+              p2t_sweep_rotate_triangle_pair (sweep, t, p, ot, op);
+              p2t_monotone_set_boundary (links, t);
+              p2t_monotone_set_boundary (links, ot);
+              g_ptr_array_add (stack, t);
+              g_ptr_array_add (stack, ot);
+            }
+        }
+    }
+
+  p2t_monotone_constrain_boundary (tcx);
+}
+
+#define P2T_MONOTONE_STACK(stack,i) (&g_array_index ((stack), P2tMonotoneVertex, (i)))
+
+/* The classic stack algorithm: the points are visited in the sweep order
+ * by merging the two chains, and the stack holds the visited points which
+ * still miss triangles above them. Those form a reflex chain on one side,
+ * except for the bottom of the stack which may be on the other side */
+void
+p2t_monotone_triangulate (P2tMonotone *THIS, P2tSweepContext *tcx, P2tPointPtrArray polygon)
+{
+  GArray *stack = THIS->stack_;
+  guint n = polygon->len, lowest = 0, highest = 0, next, prev, i, k;
+  gint orientation;
+  P2tMonotoneVertex u;
+
+  for (i = 1; i < n; i++)
+    {
+      if (p2t_monotone_before (point_index (polygon, i), point_index (polygon, lowest)))
+        lowest = i;
+      if (p2t_monotone_before (point_index (polygon, highest), point_index (polygon, i)))
+        highest = i;
+    }
+
+  next = (lowest + 1) % n;
+  prev = (lowest + n - 1) % n;
+
+  /* The lowest point is convex, so it tells the orientation of the polygon */
+  orientation = P2T_ORIENT (point_index (polygon, prev), point_index (polygon, lowest), point_index (polygon, next)) > 0 ? 1 : -1;
+
+  g_array_set_size (stack, 0);
+  u.point = point_index (polygon, lowest);
+  u.chain = 0;
+  u.below = NULL;
+  g_array_append_val (stack, u);
+
+  for (i = 1; i < n; i++)
+    {
+      P2tMonotoneVertex *top;
+
+      /* Take the lower of the points at the cursors of both chains */
+      if (next != highest && (prev == highest || p2t_monotone_before (point_index (polygon, next), point_index (polygon, prev))))
+        {
+          u.point = point_index (polygon, next);
+          u.chain = 1;
+          next = (next + 1) % n;
+        }
+      else
+        {
+          u.point = point_index (polygon, prev);
+          u.chain = -1;
+          prev = (prev + n - 1) % n;
+        }
+      u.below = NULL;
+
+      top = P2T_MONOTONE_STACK (stack, stack->len - 1);
+      if (i == 1)
+        {
+          g_array_append_val (stack, u);
+        }
+      else if (i == n - 1 || u.chain != top->chain)
+        {
+          /* The point sees the whole stack: connect it to every vertex. If
+           * it is not the highest point, the edge to the top of the stack
+           * is a diagonal and stays on the stack */
+          P2tTriangle *last = NULL, *first = NULL;
+          P2tMonotoneVertex old_top = *top;
+
+          for (k = stack->len - 1; k > 0; k--)
+            {
+              P2tMonotoneVertex *s = P2T_MONOTONE_STACK (stack, k);
+              P2tTriangle *t = p2t_monotone_add_triangle (tcx, u.point, s->point, P2T_MONOTONE_STACK (stack, k - 1)->point);
+
+              p2t_monotone_link (t, s->below);
+              p2t_monotone_link (t, last);
+              if (first == NULL)
+                first = t;
+              last = t;
+            }
+
+          old_top.below = NULL;
+          u.below = first;
+          g_array_set_size (stack, 0);
+          g_array_append_val (stack, old_top);
+          g_array_append_val (stack, u);
+        }
+      else
+        {
+          /* Cut the triangles off the reflex chain for as long as the new
+           * diagonals are inside the polygon */
+          P2tMonotoneVertex last = *top;
+          P2tTriangle *above = NULL;
+
+          g_array_set_size (stack, stack->len - 1);
+          while (stack->len > 0)
+            {
+              P2tMonotoneVertex *s = P2T_MONOTONE_STACK (stack, stack->len - 1);
+              P2tTriangle *t;
+
+              if (orientation * u.chain * P2T_ORIENT (s->point, last.point, u.point) <= 0)
+                break;
+
+              t = p2t_monotone_add_triangle (tcx, u.point, last.point, s->point);
+              p2t_monotone_link (t, last.below);
+              p2t_monotone_link (t, above);
+              above = t;
+
+              last = *s;
+              g_array_set_size (stack, stack->len - 1);
+            }
+
+          u.below = above;
+          g_array_append_val (stack, last);
+          g_array_append_val (stack, u);
+        }
+    }
+
+  p2t_monotone_constrain_boundary (tcx);
+}
@@ -0,0 +1,125 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __P2TC_P2T_MONOTONE_H__
+#define __P2TC_P2T_MONOTONE_H__
+
+#include "../common/poly2tri-private.h"
+#include "../common/shapes.h"
+
+/* The flips which make the triangulation of a monotone polygon Delaunay
+ * grow faster than the polygon, so larger ones are swept unless asked
+ * otherwise */
+#define P2T_MONOTONE_MAX_POINTS 16
+
+/**
+ * P2tMonotoneMode:
+ * @P2T_MONOTONE_AUTO: Triangulate convex polygons, and y-monotone polygons
+ *                     of up to #P2T_MONOTONE_MAX_POINTS points, without the
+ *                     sweep. Sweep all the others (the default)
+ * @P2T_MONOTONE_NEVER: Always use the sweep
+ * @P2T_MONOTONE_ALWAYS: Trust that the polygon is y-monotone and skip
+ *                       classifying it. The result is undefined if it is not
+ *
+ * How a polygon without holes and without Steiner points is triangulated.
+ * Polygons with holes or Steiner points are always swept.
+ */
+typedef enum
+{
+  P2T_MONOTONE_AUTO,
+  P2T_MONOTONE_NEVER,
+  P2T_MONOTONE_ALWAYS
+} P2tMonotoneMode;
+
+typedef enum
+{
+  /** Anything else, including polygons with collinear or repeated
+   * consecutive points */
+  P2T_MONOTONE_SHAPE_OTHER,
+  /** Monotone in the sweep order (by y and then by x) */
+  P2T_MONOTONE_SHAPE_MONOTONE,
+  /** Strictly convex */
+  P2T_MONOTONE_SHAPE_CONVEX
+} P2tMonotoneShape;
+
+/**
+ * The triangulation of convex and monotone polygons, which do not need the
+ * sweep. The work storage is kept from one polygon to the next
+ */
+struct _P2tMonotone
+{
+  /*< private >*/
+  /* The visited vertices which still miss triangles above them */
+  GArray *stack_;
+  /* The polygon neighbours of each vertex, and the order of removal */
+  GArray *links_;
+  GArray *order_;
+  /* The triangles whose edges have to be checked after an insertion */
+  GPtrArray *flip_stack_;
+};
+
+void p2t_monotone_init (P2tMonotone *THIS);
+void p2t_monotone_destroy (P2tMonotone *THIS);
+
+/**
+ * Classify a polygon in linear time
+ *
+ * @param polygon The points of a simple polygon
+ */
+P2tMonotoneShape p2t_monotone_classify (P2tPointPtrArray polygon);
+
+/**
+ * Find the Delaunay triangulation of a convex polygon in expected linear
+ * time (Chew's algorithm: the vertices are removed in a random order, and
+ * inserted back in the opposite order, flipping the new edges), adding the
+ * triangles to the result (and to the map) of the sweep context
+ *
+ * @param sweep The sweep whose flips are used
+ * @param tcx
+ * @param polygon
+ */
+void p2t_monotone_triangulate_convex (P2tMonotone *THIS, P2tSweep *sweep, P2tSweepContext *tcx, P2tPointPtrArray polygon);
+
+/**
+ * Triangulate a polygon which is monotone in the sweep order in linear
+ * time, adding the triangles to the result (and to the map) of the sweep
+ * context. The triangles are not Delaunay - see #p2t_sweep_delaunay_flip
+ *
+ * @param tcx
+ * @param polygon
+ */
+void p2t_monotone_triangulate (P2tMonotone *THIS, P2tSweepContext *tcx, P2tPointPtrArray polygon);
+
+#endif
@@ -0,0 +1,691 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <math.h>
+#include <glib.h>
+
+#include "pslg.h"
+#include "../common/predicates.h"
+
+/* The tolerance, relative to the largest coordinate of the input */
+#define P2T_PSLG_TOLERANCE 1e-12
+
+#define P2T_ORIENT(a,b,c) p2t_predicates_orient2d ((a)->x, (a)->y, (b)->x, (b)->y, (c)->x, (c)->y)
+
+/* A segment of the graph while it is split. The part of it behind the
+ * sweep line was already cut into edges */
+typedef struct
+{
+  /* The ends of the part which is left, the first one before the second
+   * in sweep order */
+  P2tPoint      *a, *b;
+  /* The place of the segment in the status, or NULL while the sweep line
+   * does not cross it (before it begins, after it ends, and while an
+   * overlapping segment stands for it) */
+  GSequenceIter *iter;
+  /* The last stop of the sweep line which found the segment there */
+  guint          stamp;
+} P2tPslgSegment;
+
+/* The kinds of events, in the order in which the events at the same point
+ * are handled. Crossings come last, so that the point of the input is
+ * used rather than an intersection point with the same coordinates */
+typedef enum
+{
+  P2T_PSLG_BEGIN,
+  P2T_PSLG_END,
+  P2T_PSLG_POINT,
+  P2T_PSLG_CROSS
+} P2tPslgEventKind;
+
+/* A point where the sweep line stops */
+typedef struct
+{
+  P2tPoint *point;
+  guint     kind;
+  /* The segment which begins or ends, or the two segments which cross */
+  guint     segment, other;
+} P2tPslgEvent;
+
+/* A point which is searched for in the status */
+typedef struct
+{
+  P2tPslg  *pslg;
+  P2tPoint *point;
+} P2tPslgProbe;
+
+#define segment_index(array,i) (&g_array_index ((array), P2tPslgSegment, (i)))
+#define event_index(array,i) (&g_array_index ((array), P2tPslgEvent, (i)))
+
+P2tPslg*
+p2t_pslg_new (void)
+{
+  P2tPslg *THIS = g_slice_new (P2tPslg);
+
+  THIS->points_ = g_ptr_array_new ();
+  THIS->input_ = g_ptr_array_new ();
+  p2t_arena_init (&THIS->arena_, P2T_PSLG_ARENA_BLOCK_SIZE);
+  THIS->segments_ = g_array_new (FALSE, FALSE, sizeof (P2tPslgSegment));
+  THIS->events_ = g_array_new (FALSE, FALSE, sizeof (P2tPslgEvent));
+  THIS->status_ = g_sequence_new (NULL);
+  THIS->starting_ = g_ptr_array_new ();
+  THIS->ending_ = g_ptr_array_new ();
+  THIS->stop_ = g_array_new (FALSE, FALSE, sizeof (P2tPslgEvent));
+  THIS->vertices_ = g_ptr_array_new ();
+  THIS->edges_ = g_array_new (FALSE, FALSE, sizeof (P2tEdge));
+
+  return THIS;
+}
+
+void
+p2t_pslg_free (P2tPslg *THIS)
+{
+  g_ptr_array_free (THIS->points_, TRUE);
+  g_ptr_array_free (THIS->input_, TRUE);
+  p2t_arena_destroy (&THIS->arena_);
+  g_array_free (THIS->segments_, TRUE);
+  g_array_free (THIS->events_, TRUE);
+  g_sequence_free (THIS->status_);
+  g_ptr_array_free (THIS->starting_, TRUE);
+  g_ptr_array_free (THIS->ending_, TRUE);
+  g_array_free (THIS->stop_, TRUE);
+  g_ptr_array_free (THIS->vertices_, TRUE);
+  g_array_free (THIS->edges_, TRUE);
+  g_slice_free (P2tPslg, THIS);
+}
+
+void
+p2t_pslg_clear (P2tPslg *THIS)
+{
+  g_ptr_array_set_size (THIS->points_, 0);
+  g_ptr_array_set_size (THIS->input_, 0);
+  p2t_arena_reset (&THIS->arena_);
+  g_ptr_array_set_size (THIS->vertices_, 0);
+  g_array_set_size (THIS->edges_, 0);
+}
+
+void
+p2t_pslg_add_point (P2tPslg *THIS, P2tPoint *point)
+{
+  g_ptr_array_add (THIS->points_, point);
+}
+
+void
+p2t_pslg_add_segment (P2tPslg *THIS, P2tPoint *p, P2tPoint *q)
+{
+  g_ptr_array_add (THIS->input_, p);
+  g_ptr_array_add (THIS->input_, q);
+}
+
+void
+p2t_pslg_add_polyline (P2tPslg *THIS, P2tPointPtrArray polyline, gboolean closed)
+{
+  guint i;
+
+  for (i = 0; i + 1 < polyline->len; i++)
+    p2t_pslg_add_segment (THIS, point_index (polyline, i), point_index (polyline, i + 1));
+  if (closed && polyline->len > 2)
+    p2t_pslg_add_segment (THIS, point_index (polyline, polyline->len - 1), point_index (polyline, 0));
+}
+
+P2tPointPtrArray
+p2t_pslg_get_points (P2tPslg *THIS)
+{
+  return THIS->vertices_;
+}
+
+GArray*
+p2t_pslg_get_edges (P2tPslg *THIS)
+{
+  return THIS->edges_;
+}
+
+/* Is p before q in sweep order (by y and then by x)? */
+static gboolean
+p2t_pslg_before (const P2tPoint *p, const P2tPoint *q)
+{
+  return p->y < q->y || (p->y == q->y && p->x < q->x);
+}
+
+static gboolean
+p2t_pslg_same (const P2tPoint *p, const P2tPoint *q)
+{
+  return p->x == q->x && p->y == q->y;
+}
+
+/* Are p and q closer than the tolerance (in each coordinate)? */
+static gboolean
+p2t_pslg_near (P2tPslg *THIS, const P2tPoint *p, const P2tPoint *q)
+{
+  return fabs (p->x - q->x) <= THIS->tolerance_ && fabs (p->y - q->y) <= THIS->tolerance_;
+}
+
+/* On which side of the line of a segment is p: 1 on the left, -1 on the
+ * right, and 0 if it is closer to the line than the tolerance */
+static gint
+p2t_pslg_side (P2tPslg *THIS, const P2tPslgSegment *s, const P2tPoint *p)
+{
+  double o = P2T_ORIENT (s->a, s->b, p);
+  double dx = s->b->x - s->a->x, dy = s->b->y - s->a->y;
+
+  if (fabs (o) <= THIS->tolerance_ * sqrt (dx * dx + dy * dy))
+    return 0;
+  return o > 0 ? 1 : -1;
+}
+
+static gboolean
+p2t_pslg_event_less (const P2tPslgEvent *e, const P2tPslgEvent *f)
+{
+  if (p2t_pslg_same (e->point, f->point))
+    return e->kind < f->kind;
+  return p2t_pslg_before (e->point, f->point);
+}
+
+/* The events are kept in a binary heap, since crossings are only found
+ * (and added) while the sweep line moves */
+static void
+p2t_pslg_push (P2tPslg *THIS, P2tPoint *point, P2tPslgEventKind kind, guint segment, guint other)
+{
+  GArray *events = THIS->events_;
+  P2tPslgEvent e;
+  guint i = events->len;
+
+  e.point = point;
+  e.kind = kind;
+  e.segment = segment;
+  e.other = other;
+  g_array_set_size (events, i + 1);
+
+  while (i > 0 && p2t_pslg_event_less (&e, event_index (events, (i - 1) / 2)))
+    {
+      *event_index (events, i) = *event_index (events, (i - 1) / 2);
+      i = (i - 1) / 2;
+    }
+  *event_index (events, i) = e;
+}
+
+static void
+p2t_pslg_pop (P2tPslg *THIS, P2tPslgEvent *top)
+{
+  GArray *events = THIS->events_;
+  P2tPslgEvent last;
+  guint n = events->len - 1, i = 0;
+
+  *top = *event_index (events, 0);
+  last = *event_index (events, n);
+  g_array_set_size (events, n);
+
+  while (2 * i + 1 < n)
+    {
+      guint child = 2 * i + 1;
+      if (child + 1 < n && p2t_pslg_event_less (event_index (events, child + 1), event_index (events, child)))
+        child++;
+      if (! p2t_pslg_event_less (event_index (events, child), &last))
+        break;
+      *event_index (events, i) = *event_index (events, child);
+      i = child;
+    }
+  if (n > 0)
+    *event_index (events, i) = last;
+}
+
+/* The order of two segments crossed by the sweep line, from left to
+ * right: the first end of the segment which begins last is compared with
+ * the line of the other segment (and if it is on that line, its second
+ * end). A NULL segment stands for the #P2tPslgProbe in @user_data, and
+ * segments going through its point compare equal to it */
+static gint
+p2t_pslg_status_cmp (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const P2tPslgSegment *s = a, *t = b;
+  gint sign = 1;
+  double o;
+
+  if (t == NULL)
+    {
+      const P2tPslgProbe *probe = user_data;
+      return p2t_pslg_side (probe->pslg, s, probe->point);
+    }
+  if (s == NULL)
+    {
+      const P2tPslgProbe *probe = user_data;
+      return - p2t_pslg_side (probe->pslg, t, probe->point);
+    }
+  if (s == t)
+    return 0;
+
+  if (p2t_pslg_before (s->a, t->a))
+    {
+      const P2tPslgSegment *tmp = s;
+      s = t;
+      t = tmp;
+      sign = -1;
+    }
+
+  o = P2T_ORIENT (t->a, t->b, s->a);
+  if (o == 0)
+    o = P2T_ORIENT (t->a, t->b, s->b);
+  /* Overlapping segments are merged as soon as they are neighbours, so
+   * any order will do */
+  if (o == 0)
+    return s < t ? -sign : sign;
+  return o > 0 ? -sign : sign;
+}
+
+/* Do two segments cross, not at one of their ends? */
+static gboolean
+p2t_pslg_cross (const P2tPslgSegment *l, const P2tPslgSegment *r, double *d3, double *d4)
+{
+  double d1 = P2T_ORIENT (l->a, l->b, r->a);
+  double d2 = P2T_ORIENT (l->a, l->b, r->b);
+
+  *d3 = P2T_ORIENT (r->a, r->b, l->a);
+  *d4 = P2T_ORIENT (r->a, r->b, l->b);
+  return ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0))
+      && ((*d3 > 0 && *d4 < 0) || (*d3 < 0 && *d4 > 0));
+}
+
+/* A crossing is found again whenever the two segments become neighbours
+ * after one of them was cut, and the intersection point may then round
+ * differently. Only the first event is used - once both segments are cut
+ * there, they no longer cross */
+static gboolean
+p2t_pslg_is_stale (P2tPslg *THIS, const P2tPslgEvent *e)
+{
+  P2tPslgSegment *s, *t;
+  double d3, d4;
+
+  if (e->kind != P2T_PSLG_CROSS)
+    return FALSE;
+  s = segment_index (THIS->segments_, e->segment);
+  t = segment_index (THIS->segments_, e->other);
+  return s->iter == NULL || t->iter == NULL || ! p2t_pslg_cross (s, t, &d3, &d4);
+}
+
+/* Remember that a segment ends at the current stop or goes through it */
+static void
+p2t_pslg_collect (P2tPslg *THIS, P2tPslgSegment *s, guint stamp)
+{
+  if (s->iter == NULL || s->stamp == stamp)
+    return;
+  s->stamp = stamp;
+  g_ptr_array_add (THIS->ending_, s);
+}
+
+static void
+p2t_pslg_take (P2tPslg *THIS, const P2tPslgEvent *e, P2tPoint *p, guint stamp)
+{
+  P2tPslgSegment *s = segment_index (THIS->segments_, e->segment);
+
+  switch (e->kind)
+    {
+      case P2T_PSLG_BEGIN:
+        s->a = p;
+        g_ptr_array_add (THIS->starting_, s);
+        break;
+      case P2T_PSLG_END:
+        p2t_pslg_collect (THIS, s, stamp);
+        break;
+      case P2T_PSLG_CROSS:
+        if (p2t_pslg_is_stale (THIS, e))
+          break;
+        p2t_pslg_collect (THIS, s, stamp);
+        p2t_pslg_collect (THIS, segment_index (THIS->segments_, e->other), stamp);
+        break;
+      default:
+        break;
+    }
+}
+
+/* Two segments which begin at the same point and go along the same line
+ * overlap up to the end of the shorter one. Only the shorter one is kept
+ * in the status, and the longer one begins again where it ends. Returns
+ * the segment which is kept */
+static P2tPslgSegment*
+p2t_pslg_merge (P2tPslg *THIS, P2tPslgSegment *s, P2tPslgSegment *t)
+{
+  P2tPslgSegment *shorter = p2t_pslg_before (t->b, s->b) ? t : s;
+  P2tPslgSegment *longer = shorter == s ? t : s;
+
+  g_sequence_remove (longer->iter);
+  longer->iter = NULL;
+  if (! p2t_pslg_same (longer->b, shorter->b))
+    p2t_pslg_push (THIS, shorter->b, P2T_PSLG_BEGIN, longer - segment_index (THIS->segments_, 0), 0);
+
+  return shorter;
+}
+
+/* Do two segments which begin at the same point go along the same line
+ * (up to the tolerance, at the end of the shorter one)? */
+static gboolean
+p2t_pslg_overlap (P2tPslg *THIS, const P2tPslgSegment *s, const P2tPslgSegment *t)
+{
+  if (! p2t_pslg_same (s->a, t->a))
+    return FALSE;
+  if (p2t_pslg_before (t->b, s->b))
+    return p2t_pslg_side (THIS, s, t->b) == 0;
+  return p2t_pslg_side (THIS, t, s->b) == 0;
+}
+
+/* Find a segment which overlaps a segment that begins at the current stop
+ * - such a segment begins there as well, and is its neighbour */
+static P2tPslgSegment*
+p2t_pslg_find_overlap (P2tPslg *THIS, P2tPslgSegment *s)
+{
+  P2tPslgSegment *t;
+
+  if (! g_sequence_iter_is_begin (s->iter))
+    {
+      t = g_sequence_get (g_sequence_iter_prev (s->iter));
+      if (p2t_pslg_overlap (THIS, s, t))
+        return t;
+    }
+  if (! g_sequence_iter_is_end (g_sequence_iter_next (s->iter)))
+    {
+      t = g_sequence_get (g_sequence_iter_next (s->iter));
+      if (p2t_pslg_overlap (THIS, s, t))
+        return t;
+    }
+  return NULL;
+}
+
+/* If two neighbours in the status cross (not at one of their ends, which
+ * is found when the sweep line gets there), add the crossing as an event.
+ * The rounded intersection point is kept between the current stop and the
+ * ends of both segments, and is moved to any of them which is near */
+static void
+p2t_pslg_check (P2tPslg *THIS, P2tPslgSegment *l, P2tPslgSegment *r, P2tPoint *p)
+{
+  P2tPslgSegment *base = segment_index (THIS->segments_, 0);
+  P2tPoint x, *point = &x;
+  double d3, d4, t;
+
+  if (! p2t_pslg_cross (l, r, &d3, &d4))
+    return;
+
+  t = d3 / (d3 - d4);
+  p2t_point_init_dd (&x, l->a->x + t * (l->b->x - l->a->x), l->a->y + t * (l->b->y - l->a->y));
+  if (! p2t_pslg_before (point, l->b) || p2t_pslg_near (THIS, point, l->b))
+    point = l->b;
+  if (! p2t_pslg_before (point, r->b) || p2t_pslg_near (THIS, point, r->b))
+    point = r->b;
+  if (! p2t_pslg_before (p, point) || p2t_pslg_near (THIS, point, p))
+    point = p;
+  if (point == &x)
+    {
+      point = p2t_arena_new (&THIS->arena_, P2tPoint);
+      *point = x;
+    }
+
+  p2t_pslg_push (THIS, point, P2T_PSLG_CROSS, l - base, r - base);
+}
+
+static void
+p2t_pslg_check_neighbours (P2tPslg *THIS, GSequenceIter *l, GSequenceIter *r, P2tPoint *p)
+{
+  if (l != NULL && r != NULL && ! g_sequence_iter_is_end (r))
+    p2t_pslg_check (THIS, g_sequence_get (l), g_sequence_get (r), p);
+}
+
+/* Was the piece from a to the current stop already added? All the pieces
+ * which end at the stop were added from @first on */
+static gboolean
+p2t_pslg_has_piece (P2tPslg *THIS, P2tPoint *a, guint first)
+{
+  guint i;
+
+  for (i = first; i < THIS->edges_->len; i++)
+    {
+      P2tEdge *edge = &g_array_index (THIS->edges_, P2tEdge, i);
+      if (edge->p == a || edge->q == a)
+        return TRUE;
+    }
+  return FALSE;
+}
+
+/* Handle a stop of the sweep line at p, once the segments which begin,
+ * end and cross there were taken from the events. The pieces which end at
+ * p were added from @first_edge on (by earlier stops at p as well) */
+static void
+p2t_pslg_stop (P2tPslg *THIS, P2tPoint *p, guint stamp, guint first_edge)
+{
+  GPtrArray *starting = THIS->starting_, *ending = THIS->ending_;
+  GSequenceIter *iter, *next;
+  P2tPslgProbe probe;
+  gboolean inserted = FALSE;
+  guint i;
+
+  for (i = 0; i < ending->len; i++)
+    {
+      P2tPslgSegment *s = g_ptr_array_index (ending, i);
+      g_sequence_remove (s->iter);
+      s->iter = NULL;
+    }
+
+  /* The segments which go through p (or near it), or end there, without an
+   * event: an end of another segment on them, or a crossing of more than
+   * two segments. They are the neighbours of p in the status */
+  probe.pslg = THIS;
+  probe.point = p;
+  iter = g_sequence_search (THIS->status_, NULL, p2t_pslg_status_cmp, &probe);
+  while (! g_sequence_iter_is_begin (iter))
+    {
+      GSequenceIter *prev = g_sequence_iter_prev (iter);
+      P2tPslgSegment *s = g_sequence_get (prev);
+
+      if (p2t_pslg_side (THIS, s, p) != 0)
+        break;
+      g_sequence_remove (prev);
+      s->iter = NULL;
+      s->stamp = stamp;
+      g_ptr_array_add (ending, s);
+    }
+  while (! g_sequence_iter_is_end (iter))
+    {
+      P2tPslgSegment *s = g_sequence_get (iter);
+
+      if (p2t_pslg_side (THIS, s, p) != 0)
+        break;
+      next = g_sequence_iter_next (iter);
+      g_sequence_remove (iter);
+      iter = next;
+      s->iter = NULL;
+      s->stamp = stamp;
+      g_ptr_array_add (ending, s);
+    }
+
+  /* Cut the segments at p. The ones which go on begin again there. Bent
+   * segments may give the same piece twice, which is then added once */
+  for (i = 0; i < ending->len; i++)
+    {
+      P2tPslgSegment *s = g_ptr_array_index (ending, i);
+
+      if (! p2t_pslg_same (s->a, p) && ! p2t_pslg_has_piece (THIS, s->a, first_edge))
+        {
+          P2tEdge edge;
+          p2t_edge_init (&edge, s->a, p);
+          g_array_append_val (THIS->edges_, edge);
+        }
+      if (! p2t_pslg_same (s->b, p))
+        {
+          s->a = p;
+          g_ptr_array_add (starting, s);
+        }
+    }
+
+  for (i = 0; i < starting->len; i++)
+    {
+      P2tPslgSegment *s = g_ptr_array_index (starting, i);
+      s->iter = g_sequence_insert_sorted (THIS->status_, s, p2t_pslg_status_cmp, NULL);
+    }
+
+  for (i = 0; i < starting->len; i++)
+    {
+      P2tPslgSegment *s = g_ptr_array_index (starting, i), *t;
+      while (s->iter != NULL && (t = p2t_pslg_find_overlap (THIS, s)) != NULL)
+        s = p2t_pslg_merge (THIS, s, t);
+    }
+
+  /* Only segments which became neighbours may cross */
+  for (i = 0; i < starting->len; i++)
+    {
+      P2tPslgSegment *s = g_ptr_array_index (starting, i);
+
+      if (s->iter == NULL)
+        continue;
+      inserted = TRUE;
+      if (! g_sequence_iter_is_begin (s->iter))
+        p2t_pslg_check_neighbours (THIS, g_sequence_iter_prev (s->iter), s->iter, p);
+      p2t_pslg_check_neighbours (THIS, s->iter, g_sequence_iter_next (s->iter), p);
+    }
+  if (! inserted && ! g_sequence_iter_is_begin (iter))
+    p2t_pslg_check_neighbours (THIS, g_sequence_iter_prev (iter), iter, p);
+}
+
+static void
+p2t_pslg_grow_tolerance (P2tPslg *THIS, const P2tPoint *p)
+{
+  THIS->tolerance_ = MAX (THIS->tolerance_, MAX (fabs (p->x), fabs (p->y)));
+}
+
+guint
+p2t_pslg_resolve (P2tPslg *THIS)
+{
+  GArray *segments = THIS->segments_;
+  P2tPoint *last = NULL;
+  guint crossings = 0, stamp = 0, first_edge = 0, i;
+
+  p2t_arena_reset (&THIS->arena_);
+  g_array_set_size (segments, 0);
+  g_array_set_size (THIS->events_, 0);
+  g_ptr_array_set_size (THIS->vertices_, 0);
+  g_array_set_size (THIS->edges_, 0);
+
+  THIS->tolerance_ = 0;
+  for (i = 0; i < THIS->points_->len; i++)
+    p2t_pslg_grow_tolerance (THIS, point_index (THIS->points_, i));
+  for (i = 0; i < THIS->input_->len; i++)
+    p2t_pslg_grow_tolerance (THIS, point_index (THIS->input_, i));
+  THIS->tolerance_ *= P2T_PSLG_TOLERANCE;
+
+  for (i = 0; i < THIS->points_->len; i++)
+    p2t_pslg_push (THIS, point_index (THIS->points_, i), P2T_PSLG_POINT, 0, 0);
+
+  for (i = 0; i + 1 < THIS->input_->len; i += 2)
+    {
+      P2tPslgSegment s;
+
+      s.a = point_index (THIS->input_, i);
+      s.b = point_index (THIS->input_, i + 1);
+      if (p2t_pslg_same (s.a, s.b))
+        {
+          p2t_pslg_push (THIS, s.a, P2T_PSLG_POINT, 0, 0);
+          continue;
+        }
+      if (p2t_pslg_before (s.b, s.a))
+        {
+          P2tPoint *tmp = s.a;
+          s.a = s.b;
+          s.b = tmp;
+        }
+      s.iter = NULL;
+      s.stamp = 0;
+
+      p2t_pslg_push (THIS, s.a, P2T_PSLG_BEGIN, segments->len, 0);
+      p2t_pslg_push (THIS, s.b, P2T_PSLG_END, segments->len, 0);
+      g_array_append_val (segments, s);
+    }
+
+  while (THIS->events_->len > 0)
+    {
+      GArray *stop = THIS->stop_;
+      P2tPslgEvent e;
+      P2tPoint *p;
+      gboolean crossing;
+
+      p2t_pslg_pop (THIS, &e);
+      if (p2t_pslg_is_stale (THIS, &e))
+        continue;
+
+      /* The events at the same point make one stop, and so do the
+       * crossings near it. The first point of the input there stands for
+       * all of them, or the first intersection point if there is none */
+      g_array_set_size (stop, 0);
+      g_array_append_val (stop, e);
+      p = e.point;
+      crossing = e.kind == P2T_PSLG_CROSS;
+      while (THIS->events_->len > 0)
+        {
+          P2tPslgEvent *f = event_index (THIS->events_, 0);
+
+          if (! p2t_pslg_same (f->point, p)
+              && ! ((crossing || f->kind == P2T_PSLG_CROSS) && p2t_pslg_near (THIS, f->point, p)))
+            break;
+          p2t_pslg_pop (THIS, &e);
+          if (p2t_pslg_is_stale (THIS, &e))
+            continue;
+          if (crossing && e.kind != P2T_PSLG_CROSS)
+            {
+              p = e.point;
+              crossing = FALSE;
+            }
+          g_array_append_val (stop, e);
+        }
+
+      /* A crossing which was rounded back to the previous stop (or near
+       * it) stops there again */
+      if (last != NULL && (p2t_pslg_same (last, p) || (crossing && p2t_pslg_near (THIS, last, p))))
+        p = last;
+      else
+        {
+          last = p;
+          first_edge = THIS->edges_->len;
+          g_ptr_array_add (THIS->vertices_, p);
+          if (crossing)
+            crossings++;
+        }
+
+      stamp++;
+      g_ptr_array_set_size (THIS->starting_, 0);
+      g_ptr_array_set_size (THIS->ending_, 0);
+      for (i = 0; i < stop->len; i++)
+        p2t_pslg_take (THIS, event_index (stop, i), p, stamp);
+
+      p2t_pslg_stop (THIS, p, stamp, first_edge);
+    }
+
+  g_assert (g_sequence_iter_is_end (g_sequence_get_begin_iter (THIS->status_)));
+  return crossings;
+}
@@ -0,0 +1,165 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __P2TC_P2T_PSLG_H__
+#define __P2TC_P2T_PSLG_H__
+
+#include "../common/poly2tri-private.h"
+#include "../common/arena.h"
+#include "../common/shapes.h"
+
+/* The size of each block in the arena of the intersection points */
+#define P2T_PSLG_ARENA_BLOCK_SIZE (16 * 1024)
+
+/**
+ * P2tPslg:
+ *
+ * A planar straight line graph - points, and segments between them which
+ * may cross, touch and overlap each other, and which may end anywhere
+ * (dangling edges that do not close any outline). Resolving it splits the
+ * segments at all the points where they meet, which gives a set of points
+ * and of constraint edges that the sweep can triangulate in one pass. The
+ * work storage is kept from one graph to the next.
+ */
+struct _P2tPslg
+{
+  /*< private >*/
+  /* The isolated points, and the endpoints of the segments (two per
+   * segment), as they were added */
+  GPtrArray *points_;
+  GPtrArray *input_;
+  /* The intersection points created by the last resolve */
+  P2tArena   arena_;
+  /* How far an intersection point may be moved (or a segment bent) to
+   * meet another point, for the rounding of the intersection points */
+  double     tolerance_;
+  /* The segments while they are split, the points where the sweep line
+   * stops (a heap), and the segments which the sweep line crosses ordered
+   * from left to right */
+  GArray    *segments_;
+  GArray    *events_;
+  GSequence *status_;
+  /* The segments which begin at the current stop of the sweep line, and
+   * the ones which end at it or go through it */
+  GPtrArray *starting_;
+  GPtrArray *ending_;
+  /* The events of the current stop */
+  GArray    *stop_;
+  /* The result - the points in sweep order, without repetitions, and the
+   * pieces of the segments (#P2tEdge) */
+  GPtrArray *vertices_;
+  GArray    *edges_;
+};
+
+P2tPslg* p2t_pslg_new (void);
+void p2t_pslg_free (P2tPslg *THIS);
+
+/**
+ * p2t_pslg_clear:
+ * @THIS: The graph
+ *
+ * Forget all the points and segments (and the result of the last resolve,
+ * including its intersection points), to start a new graph.
+ */
+void p2t_pslg_clear (P2tPslg *THIS);
+
+/**
+ * p2t_pslg_add_point:
+ * @THIS: The graph
+ * @point: A point which does not have to be the end of any segment
+ */
+void p2t_pslg_add_point (P2tPslg *THIS, P2tPoint *point);
+
+/**
+ * p2t_pslg_add_segment:
+ * @THIS: The graph
+ * @p: One end of the segment
+ * @q: The other end of the segment
+ *
+ * Points with the same coordinates are the same point of the graph, even
+ * if they are different #P2tPoint structs. A segment whose ends are the
+ * same point is added as an isolated point.
+ */
+void p2t_pslg_add_segment (P2tPslg *THIS, P2tPoint *p, P2tPoint *q);
+
+/**
+ * p2t_pslg_add_polyline:
+ * @THIS: The graph
+ * @polyline: The points of the polyline
+ * @closed: Whether there is also a segment from the last point back to
+ *          the first one
+ *
+ * Add a segment between every two consecutive points.
+ */
+void p2t_pslg_add_polyline (P2tPslg *THIS, P2tPointPtrArray polyline, gboolean closed);
+
+/**
+ * p2t_pslg_resolve:
+ * @THIS: The graph
+ *
+ * Split the segments where they cross, where one ends on another and
+ * where they overlap, with a sweep line in O((n + k) log n) for n segments
+ * and k intersections. The intersection points are rounded, so that
+ * crossings which are closer than the rounding error (relative to the
+ * largest coordinate) become one point, and segments which pass that close
+ * to a point are bent through it. The intersection points are owned by
+ * the graph until it is cleared or resolved again.
+ *
+ * Returns: The amount of intersection points which were created
+ */
+guint p2t_pslg_resolve (P2tPslg *THIS);
+
+/**
+ * p2t_pslg_get_points:
+ * @THIS: The graph
+ *
+ * Returns: All the points of the resolved graph in sweep order (by y and
+ *          then by x, up to the rounding of the intersection points),
+ *          each once. When the graph had several points with the same
+ *          coordinates, only the first of them is used
+ */
+P2tPointPtrArray p2t_pslg_get_points (P2tPslg *THIS);
+
+/**
+ * p2t_pslg_get_edges:
+ * @THIS: The graph
+ *
+ * Returns: The pieces of the segments of the resolved graph (#P2tEdge),
+ *          which only meet at their ends and use only the points of
+ *          p2t_pslg_get_points(). Overlapping segments give one edge
+ */
+GArray* p2t_pslg_get_edges (P2tPslg *THIS);
+
+#endif
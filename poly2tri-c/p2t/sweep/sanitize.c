@@ -0,0 +1,439 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include <glib.h>
+
+#include "sanitize.h"
+#include "../common/predicates.h"
+
+#define P2T_ORIENT(a,b,c) p2t_predicates_orient2d ((a)->x, (a)->y, (b)->x, (b)->y, (c)->x, (c)->y)
+
+/* An edge of an outline */
+typedef struct
+{
+  /* The endpoints, the first one before the second from left to right */
+  P2tPoint      *a, *b;
+  /* The place of the edge in the status, while the sweep line crosses it */
+  GSequenceIter *iter;
+} P2tSanitizerSegment;
+
+/* An endpoint of an edge, where the sweep line stops */
+typedef struct
+{
+  P2tPoint *point;
+  guint     segment;
+  /* 0 where the edge ends and 1 where it begins, so that the edges which
+   * end at a point leave the status before the ones which begin there */
+  guint     begins;
+} P2tSanitizerEvent;
+
+static guint
+p2t_sanitizer_hash (gconstpointer key)
+{
+  const P2tPoint *p = key;
+  guint32 w[4];
+  double c[2];
+
+  /* Adding 0.0 turns -0.0 into 0.0, which compares equal to it */
+  c[0] = p->x + 0.0;
+  c[1] = p->y + 0.0;
+  memcpy (w, c, sizeof (w));
+  return (w[0] ^ w[1] * 0x9e3779b9u) ^ (w[2] * 0x85ebca6bu ^ w[3]);
+}
+
+static gboolean
+p2t_sanitizer_equal (gconstpointer a, gconstpointer b)
+{
+  const P2tPoint *p = a, *q = b;
+  return p->x == q->x && p->y == q->y;
+}
+
+P2tSanitizer*
+p2t_sanitizer_new (void)
+{
+  P2tSanitizer *THIS = g_slice_new (P2tSanitizer);
+
+  THIS->points_ = g_ptr_array_new ();
+  THIS->offsets_ = g_array_new (FALSE, FALSE, sizeof (guint));
+  THIS->seen_ = g_hash_table_new (p2t_sanitizer_hash, p2t_sanitizer_equal);
+  THIS->segments_ = g_array_new (FALSE, FALSE, sizeof (P2tSanitizerSegment));
+  THIS->events_ = g_array_new (FALSE, FALSE, sizeof (P2tSanitizerEvent));
+  THIS->status_ = g_sequence_new (NULL);
+
+  return THIS;
+}
+
+void
+p2t_sanitizer_free (P2tSanitizer *THIS)
+{
+  g_ptr_array_free (THIS->points_, TRUE);
+  g_array_free (THIS->offsets_, TRUE);
+  g_hash_table_destroy (THIS->seen_);
+  g_array_free (THIS->segments_, TRUE);
+  g_array_free (THIS->events_, TRUE);
+  g_sequence_free (THIS->status_);
+  g_slice_free (P2tSanitizer, THIS);
+}
+
+/* Is b the tip of a spike - do the edges from a to b and from b to c go
+ * back along the same line? */
+static gboolean
+p2t_sanitizer_is_spike (P2tPoint *a, P2tPoint *b, P2tPoint *c)
+{
+  return P2T_ORIENT (a, b, c) == 0
+      && (b->x - a->x) * (c->x - b->x) + (b->y - a->y) * (c->y - b->y) <= 0;
+}
+
+/* Append the points of an outline to THIS->points_, without repeated
+ * points and without spikes. An outline with no area is dropped */
+static P2tSanitizeProblems
+p2t_sanitizer_clean (P2tSanitizer *THIS, P2tPointPtrArray outline)
+{
+  GPtrArray *out = THIS->points_;
+  P2tSanitizeProblems problems = P2T_SANITIZE_CLEAN;
+  guint start = out->len, first = start, i;
+
+  g_array_append_val (THIS->offsets_, start);
+
+  for (i = 0; i < outline->len; i++)
+    {
+      P2tPoint *p = point_index (outline, i);
+      gboolean keep = TRUE;
+
+      /* Dropping the tip of a spike may expose another spike (or a
+       * repeated point) behind it */
+      while (out->len > start)
+        {
+          P2tPoint *last = point_index (out, out->len - 1);
+
+          if (p2t_sanitizer_equal (last, p))
+            {
+              problems |= P2T_SANITIZE_DUPLICATES;
+              keep = FALSE;
+              break;
+            }
+          if (out->len - start < 2 || ! p2t_sanitizer_is_spike (point_index (out, out->len - 2), last, p))
+            break;
+          problems |= P2T_SANITIZE_SPIKES;
+          g_ptr_array_set_size (out, out->len - 1);
+        }
+
+      if (keep)
+        g_ptr_array_add (out, p);
+    }
+
+  /* The same around the point where the outline closes */
+  while (out->len - first >= 2)
+    {
+      P2tPoint *last = point_index (out, out->len - 1);
+
+      if (p2t_sanitizer_equal (last, point_index (out, first)))
+        problems |= P2T_SANITIZE_DUPLICATES;
+      else if (out->len - first >= 3 && p2t_sanitizer_is_spike (point_index (out, out->len - 2), last, point_index (out, first)))
+        problems |= P2T_SANITIZE_SPIKES;
+      else if (out->len - first >= 3 && p2t_sanitizer_is_spike (last, point_index (out, first), point_index (out, first + 1)))
+        {
+          problems |= P2T_SANITIZE_SPIKES;
+          first++;
+          continue;
+        }
+      else
+        break;
+      g_ptr_array_set_size (out, out->len - 1);
+    }
+
+  if (out->len - first < 3)
+    {
+      if (outline->len > 0)
+        problems |= P2T_SANITIZE_SPIKES;
+      g_ptr_array_set_size (out, start);
+    }
+  else if (first > start)
+    {
+      memmove (out->pdata + start, out->pdata + first, (out->len - first) * sizeof (gpointer));
+      g_ptr_array_set_size (out, out->len - (first - start));
+    }
+
+  return problems;
+}
+
+/* Replace the points of an outline with its repaired points */
+static void
+p2t_sanitizer_repair (P2tSanitizer *THIS, P2tPointPtrArray outline, guint index)
+{
+  guint start = g_array_index (THIS->offsets_, guint, index);
+  guint end = g_array_index (THIS->offsets_, guint, index + 1);
+
+  /* Repairs only drop points, so an outline of the same length is the
+   * same outline */
+  if (end - start == outline->len)
+    return;
+
+  g_ptr_array_set_size (outline, end - start);
+  memcpy (outline->pdata, THIS->points_->pdata + start, (end - start) * sizeof (gpointer));
+}
+
+/* Is p before q from left to right (by x and then by y), the order in
+ * which the sweep line of the intersection search meets them? */
+static gboolean
+p2t_sanitizer_before (const P2tPoint *p, const P2tPoint *q)
+{
+  return p->x < q->x || (p->x == q->x && p->y < q->y);
+}
+
+static gint
+p2t_sanitizer_event_cmp (gconstpointer a, gconstpointer b)
+{
+  const P2tSanitizerEvent *e = a, *f = b;
+
+  if (p2t_sanitizer_before (e->point, f->point))
+    return -1;
+  if (p2t_sanitizer_before (f->point, e->point))
+    return 1;
+  return (gint) e->begins - (gint) f->begins;
+}
+
+/* The order of two edges crossed by the sweep line, from bottom to top:
+ * the endpoint of the edge which begins last is compared with the line of
+ * the other edge */
+static gint
+p2t_sanitizer_status_cmp (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const P2tSanitizerSegment *s = a, *t = b;
+  gint sign = 1;
+  double o;
+
+  if (s == t)
+    return 0;
+  if (p2t_sanitizer_before (s->a, t->a))
+    {
+      const P2tSanitizerSegment *tmp = s;
+      s = t;
+      t = tmp;
+      sign = -1;
+    }
+
+  o = P2T_ORIENT (t->a, t->b, s->a);
+  if (o == 0)
+    o = P2T_ORIENT (t->a, t->b, s->b);
+  /* Overlapping edges - any order will do, as they are found to
+   * intersect as soon as they are neighbours */
+  if (o == 0)
+    return s < t ? -sign : sign;
+  return o > 0 ? sign : -sign;
+}
+
+/* Is p (on the line of the edge) on the edge? */
+static gboolean
+p2t_sanitizer_on_segment (const P2tSanitizerSegment *s, const P2tPoint *p)
+{
+  return MIN (s->a->x, s->b->x) <= p->x && p->x <= MAX (s->a->x, s->b->x)
+      && MIN (s->a->y, s->b->y) <= p->y && p->y <= MAX (s->a->y, s->b->y);
+}
+
+static gboolean
+p2t_sanitizer_intersect (const P2tSanitizerSegment *s, const P2tSanitizerSegment *t)
+{
+  double d1 = P2T_ORIENT (s->a, s->b, t->a);
+  double d2 = P2T_ORIENT (s->a, s->b, t->b);
+  double d3 = P2T_ORIENT (t->a, t->b, s->a);
+  double d4 = P2T_ORIENT (t->a, t->b, s->b);
+  const P2tPoint *v = NULL, *u = NULL, *w = NULL;
+
+  /* Edges with a common point are consecutive edges of an outline (any
+   * other common point was found by the hash), which only intersect if
+   * they overlap */
+  if (p2t_sanitizer_equal (s->a, t->a) || p2t_sanitizer_equal (s->a, t->b))
+    {
+      v = s->a;
+      u = s->b;
+    }
+  else if (p2t_sanitizer_equal (s->b, t->a) || p2t_sanitizer_equal (s->b, t->b))
+    {
+      v = s->b;
+      u = s->a;
+    }
+  if (v != NULL)
+    {
+      w = p2t_sanitizer_equal (v, t->a) ? t->b : t->a;
+      return d1 == 0 && d2 == 0
+          && (u->x - v->x) * (w->x - v->x) + (u->y - v->y) * (w->y - v->y) > 0;
+    }
+
+  if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
+    return TRUE;
+
+  return (d1 == 0 && p2t_sanitizer_on_segment (s, t->a))
+      || (d2 == 0 && p2t_sanitizer_on_segment (s, t->b))
+      || (d3 == 0 && p2t_sanitizer_on_segment (t, s->a))
+      || (d4 == 0 && p2t_sanitizer_on_segment (t, s->b));
+}
+
+static gboolean
+p2t_sanitizer_neighbours_intersect (GSequenceIter *below, GSequenceIter *above)
+{
+  return ! g_sequence_iter_is_end (above)
+      && p2t_sanitizer_intersect (g_sequence_get (below), g_sequence_get (above));
+}
+
+/* Look for an intersection between the edges of the outlines in
+ * THIS->points_ (Shamos and Hoey: only edges which are neighbours along
+ * the sweep line at some point need to be checked) */
+static gboolean
+p2t_sanitizer_find_intersection (P2tSanitizer *THIS)
+{
+  GArray *segments = THIS->segments_, *events = THIS->events_;
+  gboolean found = FALSE;
+  guint i, k;
+
+  g_array_set_size (segments, 0);
+  g_array_set_size (events, 0);
+  for (i = 0; i + 1 < THIS->offsets_->len; i++)
+    {
+      guint start = g_array_index (THIS->offsets_, guint, i);
+      guint end = g_array_index (THIS->offsets_, guint, i + 1);
+
+      for (k = start; k < end; k++)
+        {
+          P2tSanitizerSegment s;
+          P2tSanitizerEvent e;
+
+          s.a = point_index (THIS->points_, k);
+          s.b = point_index (THIS->points_, k + 1 < end ? k + 1 : start);
+          if (p2t_sanitizer_before (s.b, s.a))
+            {
+              P2tPoint *tmp = s.a;
+              s.a = s.b;
+              s.b = tmp;
+            }
+          s.iter = NULL;
+
+          e.segment = segments->len;
+          e.point = s.a;
+          e.begins = 1;
+          g_array_append_val (events, e);
+          e.point = s.b;
+          e.begins = 0;
+          g_array_append_val (events, e);
+          g_array_append_val (segments, s);
+        }
+    }
+  g_array_sort (events, p2t_sanitizer_event_cmp);
+
+  for (i = 0; i < events->len && ! found; i++)
+    {
+      P2tSanitizerEvent *e = &g_array_index (events, P2tSanitizerEvent, i);
+      P2tSanitizerSegment *s = &g_array_index (segments, P2tSanitizerSegment, e->segment);
+
+      if (e->begins)
+        {
+          s->iter = g_sequence_insert_sorted (THIS->status_, s, p2t_sanitizer_status_cmp, NULL);
+          found = p2t_sanitizer_neighbours_intersect (s->iter, g_sequence_iter_next (s->iter))
+              || (! g_sequence_iter_is_begin (s->iter)
+                  && p2t_sanitizer_neighbours_intersect (g_sequence_iter_prev (s->iter), s->iter));
+        }
+      else
+        {
+          GSequenceIter *above = g_sequence_iter_next (s->iter);
+          if (! g_sequence_iter_is_begin (s->iter))
+            found = p2t_sanitizer_neighbours_intersect (g_sequence_iter_prev (s->iter), above);
+          g_sequence_remove (s->iter);
+        }
+    }
+
+  /* Empty the status for the next input */
+  while (! g_sequence_iter_is_end (g_sequence_get_begin_iter (THIS->status_)))
+    g_sequence_remove (g_sequence_get_begin_iter (THIS->status_));
+
+  return found;
+}
+
+P2tSanitizeProblems
+p2t_sanitizer_check (P2tSanitizer *THIS, P2tPointPtrArray outline, P2tPointPtrArray *holes, guint n_holes, P2tPointPtrArray steiner_points, gboolean repair)
+{
+  P2tSanitizeProblems problems;
+  guint i, kept;
+
+  g_ptr_array_set_size (THIS->points_, 0);
+  g_array_set_size (THIS->offsets_, 0);
+  g_hash_table_remove_all (THIS->seen_);
+
+  problems = p2t_sanitizer_clean (THIS, outline);
+  for (i = 0; i < n_holes; i++)
+    problems |= p2t_sanitizer_clean (THIS, holes[i]);
+  g_array_append_val (THIS->offsets_, THIS->points_->len);
+
+  if (repair)
+    {
+      p2t_sanitizer_repair (THIS, outline, 0);
+      for (i = 0; i < n_holes; i++)
+        p2t_sanitizer_repair (THIS, holes[i], i + 1);
+    }
+
+  /* Any point which is still repeated is shared by two outlines, or by
+   * two parts of the same outline */
+  for (i = 0; i < THIS->points_->len; i++)
+    {
+      P2tPoint *p = point_index (THIS->points_, i);
+      if (g_hash_table_contains (THIS->seen_, p))
+        problems |= P2T_SANITIZE_TOUCHING;
+      else
+        g_hash_table_add (THIS->seen_, p);
+    }
+
+  if (steiner_points != NULL)
+    {
+      for (i = kept = 0; i < steiner_points->len; i++)
+        {
+          P2tPoint *p = point_index (steiner_points, i);
+          if (g_hash_table_contains (THIS->seen_, p))
+            {
+              problems |= P2T_SANITIZE_DUPLICATES;
+              continue;
+            }
+          g_hash_table_add (THIS->seen_, p);
+          if (repair)
+            g_ptr_array_index (steiner_points, kept++) = p;
+        }
+      if (repair)
+        g_ptr_array_set_size (steiner_points, kept);
+    }
+
+  if (p2t_sanitizer_find_intersection (THIS))
+    problems |= P2T_SANITIZE_INTERSECTIONS;
+
+  return problems;
+}
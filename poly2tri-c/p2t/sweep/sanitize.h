@@ -0,0 +1,127 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __P2TC_P2T_SANITIZE_H__
+#define __P2TC_P2T_SANITIZE_H__
+
+#include "../common/poly2tri-private.h"
+#include "../common/shapes.h"
+
+/**
+ * P2tSanitizeProblems:
+ * @P2T_SANITIZE_CLEAN: The input can be triangulated as it is
+ * @P2T_SANITIZE_DUPLICATES: A point repeats the point before it on its
+ *                           outline, or a Steiner point repeats another
+ *                           point. Repairable, by dropping the repetition
+ * @P2T_SANITIZE_SPIKES: An outline goes back on itself along a line (a
+ *                       zero width spike), or has no area at all.
+ *                       Repairable, by dropping the tip of the spike (or
+ *                       all the points of the outline)
+ * @P2T_SANITIZE_TOUCHING: Two outlines share a point, or an outline goes
+ *                         through one of its points twice (a duplicate
+ *                         point which is not next to its copy). Not
+ *                         repairable: such points are not merged, since
+ *                         the outlines would still meet at the merged
+ *                         point, which the sweep can not triangulate
+ * @P2T_SANITIZE_INTERSECTIONS: Two edges of the outlines cross or touch.
+ *                              Not repairable
+ *
+ * The problems found in the input of a triangulation. The sweep asserts
+ * (or worse, never finishes) on any of them.
+ */
+typedef enum
+{
+  P2T_SANITIZE_CLEAN = 0,
+  P2T_SANITIZE_DUPLICATES = 1 << 0,
+  P2T_SANITIZE_SPIKES = 1 << 1,
+  P2T_SANITIZE_TOUCHING = 1 << 2,
+  P2T_SANITIZE_INTERSECTIONS = 1 << 3
+} P2tSanitizeProblems;
+
+/* The problems which the sanitizer can not repair */
+#define P2T_SANITIZE_FATAL (P2T_SANITIZE_TOUCHING | P2T_SANITIZE_INTERSECTIONS)
+
+/**
+ * P2tSanitizer:
+ *
+ * Checks (and repairs what it can of) the input of a triangulation before
+ * it is given to a #P2tCDT. The work storage is kept from one input to
+ * the next.
+ */
+struct _P2tSanitizer
+{
+  /*< private >*/
+  /* The points of all the outlines after the repairs, and where each
+   * outline begins in it (with one more offset for the end) */
+  GPtrArray  *points_;
+  GArray     *offsets_;
+  /* The points seen so far, by their coordinates */
+  GHashTable *seen_;
+  /* The edges of the outlines, their endpoints from left to right, and the
+   * edges which the sweep line crosses ordered from bottom to top */
+  GArray     *segments_;
+  GArray     *events_;
+  GSequence  *status_;
+};
+
+P2tSanitizer* p2t_sanitizer_new (void);
+void p2t_sanitizer_free (P2tSanitizer *THIS);
+
+/**
+ * p2t_sanitizer_check:
+ * @THIS: The sanitizer
+ * @outline: The outline of the polygon
+ * @holes: An array of @n_holes hole outlines, or %NULL if there are none
+ * @n_holes: The amount of holes
+ * @steiner_points: Points to add inside the polygon, or %NULL
+ * @repair: Whether to repair the problems which can be repaired, by
+ *          removing points from the arrays
+ *
+ * Find the problems of the input in linear time, except for the edge
+ * intersections which are found with a sweep line in O(n log n). A
+ * repair only drops points: repeated points are dropped when they follow
+ * their copy on an outline (or when they are Steiner points), and any
+ * other duplicate point is left in place and reported as
+ * #P2T_SANITIZE_TOUCHING. After a repair which drops all the points of a
+ * hole, the hole is empty and adding it to a CDT does nothing.
+ *
+ * Returns: All the problems which were found (including the repaired
+ *          ones). The input is safe to triangulate (after the repairs, if
+ *          they were asked for) unless it has one of #P2T_SANITIZE_FATAL
+ *          or the outline has less than 3 points
+ */
+P2tSanitizeProblems p2t_sanitizer_check (P2tSanitizer *THIS, P2tPointPtrArray outline, P2tPointPtrArray *holes, guint n_holes, P2tPointPtrArray steiner_points, gboolean repair);
+
+#endif
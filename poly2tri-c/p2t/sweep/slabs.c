@@ -0,0 +1,629 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <glib.h>
+
+#include "slabs.h"
+#include "sweep.h"
+#include "sweep_context.h"
+#include "../common/predicates.h"
+
+#define P2T_ORIENT(a,b,c) p2t_predicates_orient2d ((a)->x, (a)->y, (b)->x, (b)->y, (c)->x, (c)->y)
+
+/* A vertex of a convex hull, and the triangle on the hull edge from it to
+ * the next vertex (counter-clockwise) */
+typedef struct
+{
+  P2tPoint    *point;
+  P2tTriangle *triangle;
+} P2tSlabsVertex;
+
+typedef struct
+{
+  P2tSweep        *sweep;
+  /* The context which is split, and the part of it which triangulates
+   * this slab */
+  P2tSweepContext *parent;
+  P2tSweepContext *tcx;
+  /* The points of the slab are those from start up to (excluding) end in
+   * the sweep order of the parent, and the constraint edges between them */
+  guint            start, end;
+  GPtrArray       *points;
+  GArray          *edges;
+  /* Where the input indices of the points are saved */
+  guint           *indices;
+  /* The convex hull of the triangulated slab (#P2tSlabsVertex) */
+  GArray          *hull;
+  gboolean         ok;
+} P2tSlabsSlab;
+
+#define p2t_slabs_vertex(hull, i) (&g_array_index ((hull), P2tSlabsVertex, (i)))
+
+void
+p2t_slabs_init (P2tSlabs *THIS)
+{
+  THIS->slabs_ = g_array_new (FALSE, TRUE, sizeof (P2tSlabsSlab));
+  THIS->indices_ = g_array_new (FALSE, FALSE, sizeof (guint));
+  THIS->crossing_ = g_array_new (FALSE, FALSE, sizeof (P2tEdge));
+  THIS->hull_ = g_array_new (FALSE, FALSE, sizeof (P2tSlabsVertex));
+  THIS->merged_ = g_array_new (FALSE, FALSE, sizeof (P2tSlabsVertex));
+  THIS->gap_ = g_ptr_array_new ();
+  THIS->outside_ = g_ptr_array_new ();
+  THIS->stack_ = g_ptr_array_new ();
+}
+
+void
+p2t_slabs_destroy (P2tSlabs *THIS)
+{
+  guint i;
+
+  for (i = 0; i < THIS->slabs_->len; i++)
+    {
+      P2tSlabsSlab *slab = &g_array_index (THIS->slabs_, P2tSlabsSlab, i);
+      p2t_sweep_free (slab->sweep);
+      g_ptr_array_free (slab->points, TRUE);
+      g_array_free (slab->edges, TRUE);
+      g_array_free (slab->hull, TRUE);
+    }
+
+  g_array_free (THIS->slabs_, TRUE);
+  g_array_free (THIS->indices_, TRUE);
+  g_array_free (THIS->crossing_, TRUE);
+  g_array_free (THIS->hull_, TRUE);
+  g_array_free (THIS->merged_, TRUE);
+  g_ptr_array_free (THIS->gap_, TRUE);
+  g_ptr_array_free (THIS->outside_, TRUE);
+  g_ptr_array_free (THIS->stack_, TRUE);
+}
+
+/* Is the hull edge between a and b of a triangulated point cloud also one
+ * of the constraint edges which were added to it? The edges of the hull
+ * are constraint edges of the context as well, so such an edge is there
+ * twice */
+static gboolean
+p2t_slabs_is_input_edge (P2tSweepContext *tcx, P2tPoint *a, P2tPoint *b)
+{
+  P2tEdge *edges;
+  guint n, k, count = 0;
+
+  if (p2t_point_cmp (&a, &b) > 0)
+    {
+      P2tPoint *tmp = a;
+      a = b;
+      b = tmp;
+    }
+
+  n = p2t_sweepcontext_get_point_edges (tcx, b, &edges);
+  for (k = 0; k < n; k++)
+    if (edges[k].p == a)
+      count++;
+  return count > 1;
+}
+
+/* Detach the triangles of a triangulated point cloud from the triangles
+ * outside of its convex hull, and walk around the hull. Only the input
+ * constraint edges on the hull stay constrained, so that the other hull
+ * edges can be flipped once the gap next to them is triangulated. Returns
+ * FALSE if there are no triangles */
+static gboolean
+p2t_slabs_init_hull (P2tSweepContext *tcx, GArray *hull)
+{
+  P2tTrianglePtrArray triangles = p2t_sweepcontext_get_triangles (tcx);
+  P2tTriangle *t = NULL;
+  P2tPoint *first, *p;
+  guint i;
+  int j, edge = 0;
+
+  g_array_set_size (hull, 0);
+  for (i = 0; i < triangles->len; i++)
+    {
+      P2tTriangle *ti = triangle_index (triangles, i);
+
+      for (j = 0; j < 3; j++)
+        {
+          P2tTriangle *ot = p2t_triangle_get_neighbor (ti, j);
+
+          if (ot != NULL && p2t_triangle_is_interior (ot))
+            continue;
+          if (ot != NULL)
+            p2t_triangle_clear_neighbor_tr (ti, ot);
+          if (! p2t_slabs_is_input_edge (tcx, p2t_triangle_get_point (ti, (j + 1) % 3), p2t_triangle_get_point (ti, (j + 2) % 3)))
+            p2t_triangle_set_constrained_edge (ti, j, FALSE);
+          t = ti;
+          edge = j;
+        }
+    }
+
+  if (t == NULL)
+    return FALSE;
+
+  /* The hull edge starting at a vertex p of a triangle is the edge to the
+   * next vertex of the triangle, when there is no neighbour across it.
+   * Otherwise turn around p, away from the previous hull edge */
+  first = p = p2t_triangle_get_point (t, (edge + 1) % 3);
+  do
+    {
+      P2tSlabsVertex v;
+
+      for (;;)
+        {
+          P2tTriangle *ot = p2t_triangle_get_neighbor (t, (p2t_triangle_index (t, p) + 2) % 3);
+          if (ot == NULL)
+            break;
+          t = ot;
+        }
+
+      v.point = p;
+      v.triangle = t;
+      g_array_append_val (hull, v);
+      p = p2t_triangle_point_ccw (t, p);
+    }
+  while (p != first);
+
+  return TRUE;
+}
+
+/* Triangulate one slab as a point cloud, in a thread of its own. The
+ * points of the slab get new indices in its context, so their input
+ * indices are saved first */
+static gpointer
+p2t_slabs_sweep_slab (gpointer data)
+{
+  P2tSlabsSlab *slab = (P2tSlabsSlab*) data;
+  guint i;
+
+  g_ptr_array_set_size (slab->points, 0);
+  for (i = slab->start; i < slab->end; i++)
+    {
+      P2tPoint *p = p2t_sweepcontext_get_point (slab->parent, i);
+      slab->indices[i] = p->index_;
+      g_ptr_array_add (slab->points, p);
+    }
+
+  p2t_sweepcontext_reset_point_cloud (slab->tcx, slab->points);
+  p2t_sweepcontext_set_presorted (slab->tcx, TRUE);
+  p2t_sweepcontext_set_front_index (slab->tcx, p2t_sweepcontext_get_front_index (slab->parent));
+  for (i = 0; i < slab->edges->len; i++)
+    {
+      P2tEdge *edge = &g_array_index (slab->edges, P2tEdge, i);
+      p2t_sweepcontext_add_edge (slab->tcx, edge->p, edge->q);
+    }
+
+  p2t_sweep_triangulate (slab->sweep, slab->tcx);
+  slab->ok = p2t_slabs_init_hull (slab->tcx, slab->hull);
+  return NULL;
+}
+
+/* The slab of a point - the last slab which starts at or before it */
+static guint
+p2t_slabs_find (P2tSlabs *THIS, P2tSweepContext *tcx, P2tPoint *point)
+{
+  guint lo = 1, hi = THIS->slabs_->len;
+
+  while (lo < hi)
+    {
+      guint mid = (lo + hi) / 2;
+      P2tPoint *start = p2t_sweepcontext_get_point (tcx, g_array_index (THIS->slabs_, P2tSlabsSlab, mid).start);
+
+      if (p2t_point_cmp (&start, &point) <= 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  return lo - 1;
+}
+
+static guint
+p2t_slabs_find_vertex (GArray *hull, P2tPoint *point)
+{
+  guint i;
+
+  for (i = 0; i < hull->len; i++)
+    if (p2t_slabs_vertex (hull, i)->point == point)
+      return i;
+  g_assert_not_reached ();
+  return 0;
+}
+
+/* Walk from the vertices i of the lower hull and j of the upper hull to a
+ * common tangent of both hulls, which has all their points on its left:
+ * from below to above if @up, or else from above to below. The walks go
+ * by the steps di and dj (1, or the length of the hull minus 1 to go
+ * back). Of several points on the tangent, the two closest ones are taken.
+ * Returns FALSE if the walk does not end (a degenerate hull) */
+static gboolean
+p2t_slabs_bridge (GArray *lower, guint *i, guint di, GArray *upper, guint *j, guint dj, gboolean up)
+{
+  guint steps = 0, limit = lower->len + upper->len;
+  gboolean moved;
+
+  do
+    {
+      P2tPoint *l, *u, *c;
+      double o;
+
+      moved = FALSE;
+
+      l = p2t_slabs_vertex (lower, *i)->point;
+      u = p2t_slabs_vertex (upper, *j)->point;
+      c = p2t_slabs_vertex (lower, (*i + di) % lower->len)->point;
+      o = up ? P2T_ORIENT (l, u, c) : P2T_ORIENT (u, l, c);
+      if (o < 0 || (o == 0 && p2t_point_cmp (&c, &l) > 0))
+        {
+          *i = (*i + di) % lower->len;
+          moved = TRUE;
+        }
+
+      l = p2t_slabs_vertex (lower, *i)->point;
+      c = p2t_slabs_vertex (upper, (*j + dj) % upper->len)->point;
+      o = up ? P2T_ORIENT (l, u, c) : P2T_ORIENT (u, l, c);
+      if (o < 0 || (o == 0 && p2t_point_cmp (&c, &u) < 0))
+        {
+          *j = (*j + dj) % upper->len;
+          moved = TRUE;
+        }
+    }
+  while (moved && ++steps <= limit);
+
+  return ! moved;
+}
+
+/* Add the vertices of a hull from i going counter-clockwise to the gap,
+ * with the triangle on the hull edge from each of them */
+static void
+p2t_slabs_add_chain (P2tSlabs *THIS, GArray *hull, guint i, guint n_vertices)
+{
+  guint k;
+
+  for (k = 0; k < n_vertices; k++)
+    {
+      P2tSlabsVertex *v = p2t_slabs_vertex (hull, (i + k) % hull->len);
+      g_ptr_array_add (THIS->gap_, v->point);
+      g_ptr_array_add (THIS->outside_, v->triangle);
+    }
+}
+
+/* Make the hull edges between the vertices of the gap from first on
+ * constraint edges of the gap, so that its triangulation keeps them */
+static void
+p2t_slabs_add_chain_edges (P2tSlabs *THIS, P2tSweepContext *gap, guint first, guint n_vertices, gboolean closed)
+{
+  guint k;
+
+  for (k = 0; k + 1 < n_vertices; k++)
+    p2t_sweepcontext_add_edge (gap, point_index (THIS->gap_, first + k), point_index (THIS->gap_, first + k + 1));
+  if (closed)
+    p2t_sweepcontext_add_edge (gap, point_index (THIS->gap_, first + n_vertices - 1), point_index (THIS->gap_, first));
+}
+
+/* Keep only the triangles of a triangulated gap which are between the
+ * hulls, flooding from the triangle on the first bridge. The constraint
+ * edges of the hulls stop the flood. Returns the triangle on the bridge */
+static P2tTriangle*
+p2t_slabs_flood_gap (P2tSlabs *THIS, P2tSweepContext *gap, P2tPoint *a, P2tPoint *b)
+{
+  P2tTrianglePtrArray triangles = p2t_sweepcontext_get_triangles (gap);
+  GPtrArray *stack = THIS->stack_;
+  P2tTriangle *start = NULL;
+  guint i;
+
+  for (i = 0; i < triangles->len; i++)
+    {
+      P2tTriangle *t = triangle_index (triangles, i);
+      p2t_triangle_is_interior_b (t, FALSE);
+      if (p2t_triangle_contains_pt_pt (t, a, b))
+        start = t;
+    }
+  if (start == NULL)
+    return NULL;
+
+  g_ptr_array_set_size (stack, 0);
+  p2t_triangle_is_interior_b (start, TRUE);
+  g_ptr_array_add (stack, start);
+  while (stack->len > 0)
+    {
+      P2tTriangle *t = triangle_index (stack, stack->len - 1);
+      int j;
+
+      g_ptr_array_set_size (stack, stack->len - 1);
+      for (j = 0; j < 3; j++)
+        {
+          P2tTriangle *ot = p2t_triangle_get_neighbor (t, j);
+          if (! p2t_triangle_get_constrained_edge (t, j) && ot != NULL && ! p2t_triangle_is_interior (ot))
+            {
+              p2t_triangle_is_interior_b (ot, TRUE);
+              g_ptr_array_add (stack, ot);
+            }
+        }
+    }
+
+  /* Removing the last triangles first keeps the ones which were not seen
+   * yet in their slots */
+  for (i = triangles->len; i > 0; i--)
+    if (! p2t_triangle_is_interior (triangle_index (triangles, i - 1)))
+      p2t_sweepcontext_remove_from_result (gap, triangle_index (triangles, i - 1));
+
+  return start;
+}
+
+/* Triangulate the gap between the hull of the slabs merged so far (below)
+ * and the hull of the next slab (above), attach it to the triangles on
+ * both hulls, and make THIS->hull_ the hull of both. @top is the highest
+ * point below, and @bottom the lowest point above. Returns FALSE if the
+ * gap can not be triangulated */
+static gboolean
+p2t_slabs_merge (P2tSlabs *THIS, P2tSweep *sweep, P2tSweepContext *gap, GArray *upper, P2tPoint *top, P2tPoint *bottom)
+{
+  GArray *lower = THIS->hull_, *swap;
+  guint nl = lower->len, nu = upper->len;
+  guint i1, i2, j1, j2, n_lower, n_upper, k;
+  P2tTrianglePtrArray triangles;
+  P2tTriangle *right = NULL, *left = NULL;
+  P2tPoint *m1, *m2, *u1, *u2;
+
+  /* The bridges from below to above on the right (m1 to u1) and back on
+   * the left (u2 to m2) */
+  i1 = i2 = p2t_slabs_find_vertex (lower, top);
+  j1 = j2 = p2t_slabs_find_vertex (upper, bottom);
+  if (! p2t_slabs_bridge (lower, &i1, nl - 1, upper, &j1, 1, TRUE)
+      || ! p2t_slabs_bridge (lower, &i2, 1, upper, &j2, nu - 1, FALSE))
+    return FALSE;
+  m1 = p2t_slabs_vertex (lower, i1)->point;
+  m2 = p2t_slabs_vertex (lower, i2)->point;
+  u1 = p2t_slabs_vertex (upper, j1)->point;
+  u2 = p2t_slabs_vertex (upper, j2)->point;
+
+  /* The gap is bounded by the bridges and by the hull edges from m1 to m2
+   * and from u2 to u1. When both bridges meet at a vertex, the whole hull
+   * on that side is inside the bounding box of the gap */
+  n_lower = (i1 == i2) ? nl : (i2 + nl - i1) % nl + 1;
+  n_upper = (j1 == j2) ? nu : (j1 + nu - j2) % nu + 1;
+
+  g_ptr_array_set_size (THIS->gap_, 0);
+  g_ptr_array_set_size (THIS->outside_, 0);
+  p2t_slabs_add_chain (THIS, lower, i1, n_lower);
+  p2t_slabs_add_chain (THIS, upper, j2, n_upper);
+
+  p2t_sweepcontext_reset_point_cloud (gap, THIS->gap_);
+  p2t_sweepcontext_set_presorted (gap, FALSE);
+  p2t_slabs_add_chain_edges (THIS, gap, 0, n_lower, i1 == i2);
+  p2t_slabs_add_chain_edges (THIS, gap, n_lower, n_upper, j1 == j2);
+
+  p2t_sweep_triangulate (sweep, gap);
+  right = p2t_slabs_flood_gap (THIS, gap, m1, u1);
+  if (right == NULL)
+    return FALSE;
+
+  /* Attach the gap to the hulls. The hull edge across from an edge a-b of
+   * the gap goes from b to a, so it is the one which starts at b */
+  triangles = p2t_sweepcontext_get_triangles (gap);
+  for (k = 0; k < triangles->len; k++)
+    {
+      P2tTriangle *t = triangle_index (triangles, k);
+      int j;
+
+      for (j = 0; j < 3; j++)
+        {
+          P2tTriangle *ot = p2t_triangle_get_neighbor (t, j);
+          P2tPoint *a = p2t_triangle_get_point (t, (j + 1) % 3);
+          P2tPoint *b = p2t_triangle_get_point (t, (j + 2) % 3);
+          int i;
+
+          if (ot != NULL && p2t_triangle_is_interior (ot))
+            continue;
+          if (ot != NULL)
+            p2t_triangle_clear_neighbor_tr (t, ot);
+          p2t_triangle_set_constrained_edge (t, j, FALSE);
+
+          if (a == m1 && b == u1)
+            {
+              right = t;
+              continue;
+            }
+          if (a == u2 && b == m2)
+            {
+              left = t;
+              continue;
+            }
+
+          ot = triangle_index (THIS->outside_, b->index_);
+          i = p2t_triangle_index (ot, b);
+          if (p2t_triangle_get_point (ot, (i + 1) % 3) != a || p2t_triangle_get_neighbor (ot, (i + 2) % 3) != NULL)
+            return FALSE;
+          p2t_triangle_mark_neighbor_tr (t, ot);
+          p2t_triangle_set_constrained_edge (t, j, p2t_triangle_get_constrained_edge (ot, (i + 2) % 3));
+        }
+    }
+  if (left == NULL)
+    return FALSE;
+
+  /* The new hull goes from m2 to m1 below, and from u1 to u2 above. The
+   * edges from m1 and from u2 are the bridges */
+  g_array_set_size (THIS->merged_, 0);
+  for (k = 0; k <= (i1 + nl - i2) % nl; k++)
+    g_array_append_val (THIS->merged_, *p2t_slabs_vertex (lower, (i2 + k) % nl));
+  g_array_index (THIS->merged_, P2tSlabsVertex, THIS->merged_->len - 1).triangle = right;
+  for (k = 0; k <= (j2 + nu - j1) % nu; k++)
+    g_array_append_val (THIS->merged_, *p2t_slabs_vertex (upper, (j1 + k) % nu));
+  g_array_index (THIS->merged_, P2tSlabsVertex, THIS->merged_->len - 1).triangle = left;
+
+  swap = THIS->hull_;
+  THIS->hull_ = THIS->merged_;
+  THIS->merged_ = swap;
+  return TRUE;
+}
+
+/* Give the points their input indices back */
+static void
+p2t_slabs_restore_indices (P2tSlabs *THIS, P2tSweepContext *tcx)
+{
+  guint i;
+
+  for (i = 0; i < THIS->indices_->len; i++)
+    p2t_sweepcontext_get_point (tcx, i)->index_ = g_array_index (THIS->indices_, guint, i);
+}
+
+gboolean
+p2t_slabs_triangulate (P2tSlabs *THIS, P2tSweep *sweep, P2tSweepContext *tcx)
+{
+  guint n = p2t_sweepcontext_point_count (tcx);
+  guint n_threads = p2t_sweepcontext_get_sweep_threads (tcx);
+  guint n_slabs, i, k;
+  GArray *edges = p2t_sweepcontext_get_edges (tcx);
+  P2tTrianglePtrArray map;
+  P2tTriangle *hint = NULL;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  n_slabs = MIN (n_threads, n / P2T_SLABS_MIN_POINTS);
+  if (n_slabs < 2)
+    return FALSE;
+
+  g_array_set_size (THIS->indices_, n);
+  if (THIS->slabs_->len < n_slabs)
+    {
+      k = THIS->slabs_->len;
+      g_array_set_size (THIS->slabs_, n_slabs);
+      for (; k < n_slabs; k++)
+        {
+          P2tSlabsSlab *slab = &g_array_index (THIS->slabs_, P2tSlabsSlab, k);
+          slab->sweep = p2t_sweep_new ();
+          slab->points = g_ptr_array_new ();
+          slab->edges = g_array_new (FALSE, FALSE, sizeof (P2tEdge));
+          slab->hull = g_array_new (FALSE, FALSE, sizeof (P2tSlabsVertex));
+        }
+    }
+  else
+    g_array_set_size (THIS->slabs_, n_slabs);
+
+  for (k = 0; k < n_slabs; k++)
+    {
+      P2tSlabsSlab *slab = &g_array_index (THIS->slabs_, P2tSlabsSlab, k);
+      slab->parent = tcx;
+      slab->tcx = p2t_sweepcontext_get_part (tcx, k);
+      slab->start = (guint) ((guint64) n * k / n_slabs);
+      slab->end = (guint) ((guint64) n * (k + 1) / n_slabs);
+      slab->indices = &g_array_index (THIS->indices_, guint, 0);
+      g_array_set_size (slab->edges, 0);
+    }
+
+  /* A constraint edge inside a slab is swept with it, and an edge between
+   * two slabs is recovered once they are merged */
+  g_array_set_size (THIS->crossing_, 0);
+  for (i = 0; i < edges->len; i++)
+    {
+      P2tEdge *edge = &g_array_index (edges, P2tEdge, i);
+      guint kp = p2t_slabs_find (THIS, tcx, edge->p);
+
+      if (kp == p2t_slabs_find (THIS, tcx, edge->q))
+        g_array_append_val (g_array_index (THIS->slabs_, P2tSlabsSlab, kp).edges, *edge);
+      else
+        g_array_append_val (THIS->crossing_, *edge);
+    }
+
+  {
+    GThread **threads = g_new (GThread*, n_slabs);
+    gboolean ok = TRUE;
+
+    for (k = 1; k < n_slabs; k++)
+      threads[k] = g_thread_new ("p2t-slab", p2t_slabs_sweep_slab, &g_array_index (THIS->slabs_, P2tSlabsSlab, k));
+    p2t_slabs_sweep_slab (&g_array_index (THIS->slabs_, P2tSlabsSlab, 0));
+    for (k = 1; k < n_slabs; k++)
+      g_thread_join (threads[k]);
+    g_free (threads);
+
+    for (k = 0; k < n_slabs; k++)
+      ok = ok && g_array_index (THIS->slabs_, P2tSlabsSlab, k).ok;
+
+    /* Merge the slabs from the bottom up */
+    if (ok)
+      {
+        GArray *hull = g_array_index (THIS->slabs_, P2tSlabsSlab, 0).hull;
+
+        g_array_set_size (THIS->hull_, 0);
+        g_array_append_vals (THIS->hull_, hull->data, hull->len);
+        for (k = 1; ok && k < n_slabs; k++)
+          {
+            P2tSlabsSlab *slab = &g_array_index (THIS->slabs_, P2tSlabsSlab, k);
+            ok = p2t_slabs_merge (THIS, sweep, p2t_sweepcontext_get_part (tcx, n_slabs + k - 1), slab->hull,
+                                  p2t_sweepcontext_get_point (tcx, slab->start - 1),
+                                  p2t_sweepcontext_get_point (tcx, slab->start));
+          }
+      }
+
+    p2t_slabs_restore_indices (THIS, tcx);
+    if (! ok)
+      return FALSE;
+  }
+
+  /* Only the edges of the gaps may not be Delaunay yet */
+  for (k = n_slabs; k < 2 * n_slabs - 1; k++)
+    p2t_sweep_delaunay_flip_triangles (sweep, p2t_sweepcontext_get_triangles (p2t_sweepcontext_get_part (tcx, k)));
+
+  for (k = 0; k < 2 * n_slabs - 1; k++)
+    {
+      P2tTrianglePtrArray triangles = p2t_sweepcontext_get_triangles (p2t_sweepcontext_get_part (tcx, k));
+
+      for (i = 0; i < triangles->len; i++)
+        {
+          P2tTriangle *t = triangle_index (triangles, i);
+          p2t_sweepcontext_add_to_map (tcx, t);
+          p2t_sweepcontext_add_to_result (tcx, t);
+        }
+    }
+
+  for (i = 0; i < THIS->crossing_->len; i++)
+    {
+      P2tEdge *edge = &g_array_index (THIS->crossing_, P2tEdge, i);
+      hint = p2t_sweep_insert_edge (sweep, tcx, edge->p, edge->q, hint);
+    }
+
+  /* The whole convex hull is triangulated, so leave out what is outside of
+   * the polygon */
+  if (! p2t_sweepcontext_is_point_cloud (tcx))
+    {
+      map = p2t_sweepcontext_get_map (tcx);
+      for (i = 0; i < map->len; i++)
+        {
+          P2tTriangle *t = triangle_index (map, i);
+          if (! p2t_sweepcontext_is_interior_triangle (tcx, t))
+            {
+              p2t_triangle_is_interior_b (t, FALSE);
+              p2t_sweepcontext_remove_from_result (tcx, t);
+            }
+        }
+    }
+
+  return TRUE;
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is a part of the C port of the Poly2Tri library
+ * Porting to C done by (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * Poly2Tri Copyright (c) 2009-2010, Poly2Tri Contributors
+ * http://code.google.com/p/poly2tri/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef __P2TC_P2T_SLABS_H__
+#define __P2TC_P2T_SLABS_H__
+
+#include "../common/poly2tri-private.h"
+#include "../common/shapes.h"
+
+/* The minimal amount of points in each slab of a parallel sweep */
+#define P2T_SLABS_MIN_POINTS 4096
+
+/**
+ * The parallel sweep of one large input. The points are split into slabs
+ * of consecutive points in the sweep order, which are triangulated at the
+ * same time as point clouds (each with the constraint edges inside it).
+ * Then the gaps between the convex hulls of neighbouring slabs are
+ * triangulated, the whole triangulation is flipped until it is Delaunay,
+ * and the constraint edges which go from one slab to another are
+ * recovered. The work storage is kept from one sweep to the next
+ */
+struct _P2tSlabs
+{
+  /*< private >*/
+  /* The slabs of the last sweep, with the sweep and the work storage of
+   * each (#P2tSlabsSlab), which are kept for the next sweeps */
+  GArray *slabs_;
+  /* The input index of each point, in the sweep order. The contexts of
+   * the slabs and of the gaps overwrite them */
+  GArray *indices_;
+  /* The constraint edges between points of different slabs */
+  GArray *crossing_;
+  /* The convex hull of the slabs merged so far, and the next one, as
+   * #P2tSlabsVertex in counter-clockwise order */
+  GArray *hull_;
+  GArray *merged_;
+  /* The points of the gap between two hulls, and for each of them the
+   * triangle on the hull edge which starts at it */
+  GPtrArray *gap_;
+  GPtrArray *outside_;
+  /* The triangles waiting to be flooded */
+  GPtrArray *stack_;
+};
+
+void p2t_slabs_init (P2tSlabs *THIS);
+void p2t_slabs_destroy (P2tSlabs *THIS);
+
+/**
+ * Triangulate a sweep context in parallel, if it is large enough and its
+ * sweep threads allow more than one slab. The context must be prepared
+ * with p2t_sweepcontext_init_triangulation(). The result is the
+ * constrained Delaunay triangulation, like the serial sweep followed by
+ * p2t_sweep_delaunay_flip(), and the map holds only the triangles inside
+ * the convex hull of the points. The triangles of the slabs are owned by
+ * the parts of the context (see p2t_sweepcontext_get_part())
+ *
+ * @param sweep The sweep whose flips and edits are used
+ * @param tcx
+ * @return FALSE (with nothing triangulated) if the context has to be swept
+ *         serially - it is too small, or a slab is degenerate
+ */
+gboolean p2t_slabs_triangulate (P2tSlabs *THIS, P2tSweep *sweep, P2tSweepContext *tcx);
+
+#endif
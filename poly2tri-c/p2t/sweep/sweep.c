@@ -40,11 +40,50 @@
 #include "advancing_front.h"
 #include "../common/utils.h"
 #include "../common/shapes.h"
+#include "../common/predicates.h"
+
+/* A pending step of the legalization of a triangle. Once the shared edge
+ * of @t and @ot was flipped, both triangles are legalized in turn and then
+ * the delaunay flags of the edge (@i in @t, @oi in @ot) are reset */
+typedef enum
+{
+  P2T_SWEEP_LEGALIZE_START,
+  P2T_SWEEP_LEGALIZE_AFTER_T,
+  P2T_SWEEP_LEGALIZE_AFTER_OT
+} P2tSweepLegalizeState;
+
+typedef struct
+{
+  P2tTriangle *t, *ot;
+  int i, oi;
+  P2tSweepLegalizeState state;
+} P2tSweepLegalizeFrame;
+
+/* The steps of the edge event, which used to call each other */
+typedef enum
+{
+  P2T_SWEEP_EDGE_EVENT,
+  P2T_SWEEP_FLIP_EDGE_EVENT,
+  P2T_SWEEP_FLIP_SCAN_EDGE_EVENT,
+  P2T_SWEEP_EDGE_EVENT_DONE
+} P2tSweepEdgeEventStep;
+
+typedef struct
+{
+  P2tPoint *ep, *eq;
+  P2tTriangle *flip_triangle, *t;
+  P2tPoint *p;
+} P2tSweepEdgeEventFrame;
 
 void
 p2t_sweep_init (P2tSweep* THIS)
 {
-  THIS->nodes_ = g_ptr_array_new ();
+  THIS->legalize_stack_ = g_array_new (FALSE, FALSE, sizeof (P2tSweepLegalizeFrame));
+  THIS->edge_event_stack_ = g_array_new (FALSE, FALSE, sizeof (P2tSweepEdgeEventFrame));
+  THIS->flip_stack_ = g_ptr_array_new ();
+  p2t_monotone_init (&THIS->monotone_);
+  p2t_insert_init (&THIS->insert_);
+  p2t_slabs_init (&THIS->slabs_);
 }
 
 P2tSweep*
@@ -61,14 +100,12 @@ p2t_sweep_new ()
 void
 p2t_sweep_destroy (P2tSweep* THIS)
 {
-  guint i;
-  /* Clean up memory */
-  for (i = 0; i < THIS->nodes_->len; i++)
-    {
-      p2t_node_free (node_index (THIS->nodes_, i));
-    }
-
-  g_ptr_array_free (THIS->nodes_, TRUE);
+  g_array_free (THIS->legalize_stack_, TRUE);
+  g_array_free (THIS->edge_event_stack_, TRUE);
+  g_ptr_array_free (THIS->flip_stack_, TRUE);
+  p2t_monotone_destroy (&THIS->monotone_);
+  p2t_insert_destroy (&THIS->insert_);
+  p2t_slabs_destroy (&THIS->slabs_);
 }
 
 void
@@ -78,17 +115,86 @@ p2t_sweep_free (P2tSweep* THIS)
   g_free (THIS);
 }
 
+/* Triangulate a polygon without holes and Steiner points without the
+ * sweep if it is convex or monotone. Returns FALSE if it has to be swept */
+static gboolean
+p2t_sweep_triangulate_monotone (P2tSweep *THIS, P2tSweepContext *tcx)
+{
+  P2tPointPtrArray polygon = p2t_sweepcontext_get_lone_polyline (tcx);
+  P2tMonotoneShape shape;
+
+  if (polygon == NULL)
+    return FALSE;
+
+  switch (p2t_sweepcontext_get_monotone_mode (tcx))
+    {
+    case P2T_MONOTONE_NEVER:
+      return FALSE;
+    case P2T_MONOTONE_ALWAYS:
+      shape = (polygon->len >= 3) ? P2T_MONOTONE_SHAPE_MONOTONE : P2T_MONOTONE_SHAPE_OTHER;
+      break;
+    default:
+      shape = p2t_monotone_classify (polygon);
+      if (shape == P2T_MONOTONE_SHAPE_MONOTONE && polygon->len > P2T_MONOTONE_MAX_POINTS)
+        return FALSE;
+      break;
+    }
+
+  if (shape == P2T_MONOTONE_SHAPE_CONVEX)
+    {
+      p2t_monotone_triangulate_convex (&THIS->monotone_, THIS, tcx, polygon);
+    }
+  else if (shape == P2T_MONOTONE_SHAPE_MONOTONE)
+    {
+      p2t_monotone_triangulate (&THIS->monotone_, tcx, polygon);
+      p2t_sweep_delaunay_flip (THIS, tcx);
+    }
+  else
+    return FALSE;
+
+  return TRUE;
+}
+
 /* Triangulate simple polygon with holes */
 
 void
 p2t_sweep_triangulate (P2tSweep *THIS, P2tSweepContext *tcx)
 {
-  p2t_sweepcontext_init_triangulation (tcx);
-  p2t_sweepcontext_create_advancingfront (tcx, THIS->nodes_);
+  if (p2t_sweep_triangulate_monotone (THIS, tcx))
+    return;
+  if (! p2t_sweepcontext_init_triangulation (tcx))
+    return;
+  if (p2t_slabs_triangulate (&THIS->slabs_, THIS, tcx))
+    return;
+  p2t_sweepcontext_create_advancingfront (tcx);
   /* Sweep points; build mesh */
   p2t_sweep_sweep_points (THIS, tcx);
   /* Clean up */
-  p2t_sweep_finalization_polygon (THIS, tcx);
+  if (p2t_sweepcontext_is_point_cloud (tcx))
+    {
+      p2t_sweep_finalization_point_cloud (THIS, tcx);
+      p2t_sweep_delaunay_flip (THIS, tcx);
+    }
+  else
+    p2t_sweep_finalization_polygon (THIS, tcx);
+}
+
+P2tTriangle*
+p2t_sweep_insert_point (P2tSweep *THIS, P2tSweepContext *tcx, P2tPoint *point, P2tTriangle *hint)
+{
+  return p2t_insert_point (&THIS->insert_, THIS, tcx, point, hint);
+}
+
+gboolean
+p2t_sweep_insert_hole (P2tSweep *THIS, P2tSweepContext *tcx, P2tPointPtrArray polyline)
+{
+  return p2t_insert_hole (&THIS->insert_, THIS, tcx, polyline);
+}
+
+P2tTriangle*
+p2t_sweep_insert_edge (P2tSweep *THIS, P2tSweepContext *tcx, P2tPoint *p, P2tPoint *q, P2tTriangle *hint)
+{
+  return p2t_insert_edge (&THIS->insert_, THIS, tcx, p, q, hint);
 }
 
 void
@@ -100,9 +206,11 @@ p2t_sweep_sweep_points (P2tSweep *THIS, P2tSweepContext *tcx)
     {
       P2tPoint* point = p2t_sweepcontext_get_point (tcx, i);
       P2tNode* node = p2t_sweep_point_event (THIS, tcx, point);
-      for (j = 0; j < point->edge_list->len; j++)
+      P2tEdge* edges;
+      guint n_edges = p2t_sweepcontext_get_point_edges (tcx, point, &edges);
+      for (j = 0; j < n_edges; j++)
         {
-          p2t_sweep_edge_event_ed_n (THIS, tcx, edge_index (point->edge_list, j), node);
+          p2t_sweep_edge_event_ed_n (THIS, tcx, &edges[j], node);
         }
     }
 }
@@ -110,16 +218,90 @@ p2t_sweep_sweep_points (P2tSweep *THIS, P2tSweepContext *tcx)
 void
 p2t_sweep_finalization_polygon (P2tSweep *THIS, P2tSweepContext *tcx)
 {
-  /* Get an Internal triangle to start with */
-  P2tTriangle* t = p2t_advancingfront_head (p2t_sweepcontext_front (tcx))->next->triangle;
-  P2tPoint* p = p2t_advancingfront_head (p2t_sweepcontext_front (tcx))->next->point;
-  while (!p2t_triangle_get_constrained_edge_cw (t, p))
+  P2tTrianglePtrArray map = p2t_sweepcontext_get_map (tcx);
+  guint i;
+
+  /* Each triangle is classified by the side of the outline or the hole
+   * it touches, so there is no need to flood the mesh from a seed, and the
+   * interior triangles are collected in the order they were created */
+  for (i = 0; i < map->len; i++)
     {
-      t = p2t_triangle_neighbor_ccw (t, p);
+      P2tTriangle *t = triangle_index (map, i);
+      if (p2t_sweepcontext_is_interior_triangle (tcx, t))
+        {
+          p2t_triangle_is_interior_b (t, TRUE);
+          p2t_sweepcontext_add_to_result (tcx, t);
+        }
     }
+}
+
+void
+p2t_sweep_finalization_point_cloud (P2tSweep *THIS, P2tSweepContext *tcx)
+{
+  P2tTrianglePtrArray map = p2t_sweepcontext_get_map (tcx);
+  P2tPoint *head = p2t_sweepcontext_head (tcx);
+  P2tPoint *tail = p2t_sweepcontext_tail (tcx);
+  guint i;
+
+  /* The hull edges are constrained, so every triangle made only of input
+   * points lies inside the hull, and every other triangle lies outside */
+  for (i = 0; i < map->len; i++)
+    {
+      P2tTriangle *t = triangle_index (map, i);
+      if (! p2t_triangle_contains_pt (t, head) && ! p2t_triangle_contains_pt (t, tail))
+        {
+          p2t_triangle_is_interior_b (t, TRUE);
+          p2t_sweepcontext_add_to_result (tcx, t);
+        }
+    }
+}
+
+void
+p2t_sweep_delaunay_flip (P2tSweep *THIS, P2tSweepContext *tcx)
+{
+  p2t_sweep_delaunay_flip_triangles (THIS, p2t_sweepcontext_get_triangles (tcx));
+}
+
+void
+p2t_sweep_delaunay_flip_triangles (P2tSweep *THIS, P2tTrianglePtrArray triangles)
+{
+  GPtrArray *stack = THIS->flip_stack_;
+  guint i;
+
+  g_ptr_array_set_size (stack, 0);
+  for (i = 0; i < triangles->len; i++)
+    g_ptr_array_add (stack, triangle_index (triangles, i));
+
+  while (stack->len > 0)
+    {
+      P2tTriangle *t = triangle_index (stack, stack->len - 1);
+      int j;
 
-  /* Collect interior triangles constrained by edges */
-  p2t_sweepcontext_mesh_clean (tcx, t);
+      g_ptr_array_set_size (stack, stack->len - 1);
+      for (j = 0; j < 3; j++)
+        {
+          P2tTriangle *ot = p2t_triangle_get_neighbor (t, j);
+          P2tPoint *p, *op;
+
+          if (ot == NULL || p2t_triangle_get_constrained_edge (t, j) || ! p2t_triangle_is_interior (ot))
+            continue;
+
+          p = p2t_triangle_get_point (t, j);
+          op = p2t_triangle_opposite_point (ot, t, p);
+          if (p2t_triangle_get_constrained_edge (ot, p2t_triangle_index (ot, op)))
+            continue;
+
+          if (p2t_sweep_incircle (THIS, p, p2t_triangle_point_ccw (t, p), p2t_triangle_point_cw (t, p), op))
+            {
+              /* Both triangles changed, so all their edges must be checked
+               * again (the flipped edge itself is now Delaunay) */
+              p2t_sweep_rotate_triangle_pair (THIS, t, p, ot, op);
+              g_ptr_array_add (stack, t);
+              g_ptr_array_add (stack, ot);
+              break;
+            }
+        }
+    }
 }
 
 P2tNode*
@@ -160,57 +342,59 @@ p2t_sweep_edge_event_ed_n (P2tSweep *THIS, P2tSweepContext *tcx, P2tEdge* edge,
   p2t_sweep_edge_event_pt_pt_tr_pt (THIS, tcx, edge->p, edge->q, node->triangle, edge->q);
 }
 
-void
-p2t_sweep_edge_event_pt_pt_tr_pt (P2tSweep *THIS, P2tSweepContext *tcx, P2tPoint* ep, P2tPoint* eq, P2tTriangle* triangle, P2tPoint* point)
+static P2tSweepEdgeEventStep
+p2t_sweep_edge_event_step (P2tSweep *THIS, P2tSweepContext *tcx, P2tSweepEdgeEventFrame *f)
 {
   P2tPoint *p1, *p2;
   P2tOrientation o1, o2;
 
-  if (p2t_sweep_is_edge_side_of_triangle (THIS, triangle, ep, eq))
+  if (p2t_sweep_is_edge_side_of_triangle (THIS, f->t, f->ep, f->eq))
     {
-      return;
+      return P2T_SWEEP_EDGE_EVENT_DONE;
     }
 
-  p1 = p2t_triangle_point_ccw (triangle, point);
-  o1 = p2t_orient2d (eq, p1, ep);
+  p1 = p2t_triangle_point_ccw (f->t, f->p);
+  o1 = p2t_orient2d (f->eq, p1, f->ep);
   if (o1 == COLLINEAR)
     {
-      if (p2t_triangle_contains_pt_pt (triangle, eq, p1))
+      if (p2t_triangle_contains_pt_pt (f->t, f->eq, p1))
         {
-          p2t_triangle_mark_constrained_edge_pt_pt (triangle, eq, p1);
+          p2t_triangle_mark_constrained_edge_pt_pt (f->t, f->eq, p1);
           /* We are modifying the constraint maybe it would be better to
            * not change the given constraint and just keep a variable for the new constraint
            */
           tcx->edge_event.constrained_edge->q = p1;
-          triangle = p2t_triangle_neighbor_across (triangle, point);
-          p2t_sweep_edge_event_pt_pt_tr_pt (THIS, tcx, ep, p1, triangle, p1);
+          f->t = p2t_triangle_neighbor_across (f->t, f->p);
+          f->eq = f->p = p1;
+          return P2T_SWEEP_EDGE_EVENT;
         }
       else
         {
           g_error ("EdgeEvent - collinear points not supported");
         }
-      return;
+      return P2T_SWEEP_EDGE_EVENT_DONE;
     }
 
-  p2 = p2t_triangle_point_cw (triangle, point);
-  o2 = p2t_orient2d (eq, p2, ep);
+  p2 = p2t_triangle_point_cw (f->t, f->p);
+  o2 = p2t_orient2d (f->eq, p2, f->ep);
   if (o2 == COLLINEAR)
     {
-      if (p2t_triangle_contains_pt_pt (triangle, eq, p2))
+      if (p2t_triangle_contains_pt_pt (f->t, f->eq, p2))
         {
-          p2t_triangle_mark_constrained_edge_pt_pt (triangle, eq, p2);
+          p2t_triangle_mark_constrained_edge_pt_pt (f->t, f->eq, p2);
           /* We are modifying the constraint maybe it would be better to
            * not change the given constraint and just keep a variable for the new constraint
            */
           tcx->edge_event.constrained_edge->q = p2;
-          triangle = p2t_triangle_neighbor_across (triangle, point);
-          p2t_sweep_edge_event_pt_pt_tr_pt (THIS, tcx, ep, p2, triangle, p2);
+          f->t = p2t_triangle_neighbor_across (f->t, f->p);
+          f->eq = f->p = p2;
+          return P2T_SWEEP_EDGE_EVENT;
         }
       else
         {
           g_error ("EdgeEvent - collinear points not supported");
         }
-      return;
+      return P2T_SWEEP_EDGE_EVENT_DONE;
     }
 
   if (o1 == o2)
@@ -219,21 +403,164 @@ p2t_sweep_edge_event_pt_pt_tr_pt (P2tSweep *THIS, P2tSweepContext *tcx, P2tPoint
        * that will cross edge */
       if (o1 == CW)
         {
-          triangle = p2t_triangle_neighbor_ccw (triangle, point);
+          f->t = p2t_triangle_neighbor_ccw (f->t, f->p);
         }
       else
         {
-          triangle = p2t_triangle_neighbor_cw (triangle, point);
+          f->t = p2t_triangle_neighbor_cw (f->t, f->p);
         }
-      p2t_sweep_edge_event_pt_pt_tr_pt (THIS, tcx, ep, eq, triangle, point);
+      return P2T_SWEEP_EDGE_EVENT;
     }
   else
     {
       /* This triangle crosses constraint so lets flippin start! */
-      p2t_sweep_flip_edge_event (THIS, tcx, ep, eq, triangle, point);
+      return P2T_SWEEP_FLIP_EDGE_EVENT;
     }
 }
 
+static P2tSweepEdgeEventStep
+p2t_sweep_flip_edge_event_step (P2tSweep *THIS, P2tSweepContext *tcx, P2tSweepEdgeEventFrame *f)
+{
+  P2tPoint *ep = f->ep, *eq = f->eq, *p = f->p;
+  P2tTriangle *t = f->t;
+  P2tTriangle* ot = p2t_triangle_neighbor_across (t, p);
+  P2tPoint* op = p2t_triangle_opposite_point (ot, t, p);
+
+  if (ot == NULL)
+    {
+      /* If we want to integrate the fillEdgeEvent do it here
+       * With current implementation we should never get here
+       *throw new RuntimeException( "[BUG:FIXME] FLIP failed due to missing triangle");
+       */
+      assert (0);
+    }
+
+  if (p2t_utils_in_scan_area (p, p2t_triangle_point_ccw (t, p), p2t_triangle_point_cw (t, p), op))
+    {
+      /* Lets rotate shared edge one vertex CW */
+      p2t_sweep_rotate_triangle_pair (THIS, t, p, ot, op);
+      p2t_sweepcontext_map_triangle_to_nodes (tcx, t);
+      p2t_sweepcontext_map_triangle_to_nodes (tcx, ot);
+
+      if (p == eq && op == ep)
+        {
+          if (p2t_point_equals (eq, tcx->edge_event.constrained_edge->q) && p2t_point_equals (ep, tcx->edge_event.constrained_edge->p))
+            {
+              p2t_triangle_mark_constrained_edge_pt_pt (t, ep, eq);
+              p2t_triangle_mark_constrained_edge_pt_pt (ot, ep, eq);
+              p2t_sweep_legalize (THIS, tcx, t);
+              p2t_sweep_legalize (THIS, tcx, ot);
+            }
+          else
+            {
+              /* XXX: I think one of the triangles should be legalized here? */
+            }
+          return P2T_SWEEP_EDGE_EVENT_DONE;
+        }
+      else
+        {
+          P2tOrientation o = p2t_orient2d (eq, op, ep);
+          f->t = p2t_sweep_next_flip_triangle (THIS, tcx, (int) o, t, ot, p, op);
+          return P2T_SWEEP_FLIP_EDGE_EVENT;
+        }
+    }
+  else
+    {
+      /* Once the scan is done, the edge event continues from this
+       * triangle and point */
+      g_array_append_val (THIS->edge_event_stack_, *f);
+      f->flip_triangle = t;
+      f->t = ot;
+      f->p = p2t_sweep_next_flip_point (THIS, ep, eq, ot, op);
+      return P2T_SWEEP_FLIP_SCAN_EDGE_EVENT;
+    }
+}
+
+static P2tSweepEdgeEventStep
+p2t_sweep_flip_scan_edge_event_step (P2tSweep *THIS, P2tSweepContext *tcx, P2tSweepEdgeEventFrame *f)
+{
+  P2tPoint *ep = f->ep, *eq = f->eq, *p = f->p;
+  P2tTriangle *flip_triangle = f->flip_triangle, *t = f->t;
+  P2tTriangle* ot = p2t_triangle_neighbor_across (t, p);
+  P2tPoint* op = p2t_triangle_opposite_point (ot, t, p);
+
+  if (p2t_triangle_neighbor_across (t, p) == NULL)
+    {
+      /* If we want to integrate the fillEdgeEvent do it here
+       * With current implementation we should never get here
+       *throw new RuntimeException( "[BUG:FIXME] FLIP failed due to missing triangle");
+       */
+      assert (0);
+    }
+
+  if (p2t_utils_in_scan_area (eq, p2t_triangle_point_ccw (flip_triangle, eq), p2t_triangle_point_cw (flip_triangle, eq), op))
+    {
+      /* flip with new edge op->eq
+       * TODO: Actually I just figured out that it should be possible to
+       *       improve this by getting the next ot and op before the the above
+       *       flip and continue the flipScanEdgeEvent here
+       * set new ot and op here and loop back to inScanArea test
+       * also need to set a new flip_triangle first
+       * Turns out at first glance that this is somewhat complicated
+       * so it will have to wait. */
+      f->ep = eq;
+      f->eq = op;
+      f->t = ot;
+      f->p = op;
+      return P2T_SWEEP_FLIP_EDGE_EVENT;
+    }
+  else
+    {
+      f->t = ot;
+      f->p = p2t_sweep_next_flip_point (THIS, ep, eq, ot, op);
+      return P2T_SWEEP_FLIP_SCAN_EDGE_EVENT;
+    }
+}
+
+/* Runs the edge event steps starting from @step, until no step and no
+ * pending continuation of a flip scan remains */
+static void
+p2t_sweep_run_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2tSweepEdgeEventStep step, P2tSweepEdgeEventFrame *f)
+{
+  GArray *stack = THIS->edge_event_stack_;
+  guint base = stack->len;
+
+  while (TRUE)
+    {
+      switch (step)
+        {
+        case P2T_SWEEP_EDGE_EVENT:
+          step = p2t_sweep_edge_event_step (THIS, tcx, f);
+          break;
+        case P2T_SWEEP_FLIP_EDGE_EVENT:
+          step = p2t_sweep_flip_edge_event_step (THIS, tcx, f);
+          break;
+        case P2T_SWEEP_FLIP_SCAN_EDGE_EVENT:
+          step = p2t_sweep_flip_scan_edge_event_step (THIS, tcx, f);
+          break;
+        case P2T_SWEEP_EDGE_EVENT_DONE:
+          if (stack->len == base)
+            return;
+          *f = g_array_index (stack, P2tSweepEdgeEventFrame, stack->len - 1);
+          g_array_set_size (stack, stack->len - 1);
+          step = P2T_SWEEP_EDGE_EVENT;
+          break;
+        }
+    }
+}
+
+void
+p2t_sweep_edge_event_pt_pt_tr_pt (P2tSweep *THIS, P2tSweepContext *tcx, P2tPoint* ep, P2tPoint* eq, P2tTriangle* triangle, P2tPoint* point)
+{
+  P2tSweepEdgeEventFrame f;
+  f.ep = ep;
+  f.eq = eq;
+  f.flip_triangle = NULL;
+  f.t = triangle;
+  f.p = point;
+  p2t_sweep_run_edge_event (THIS, tcx, P2T_SWEEP_EDGE_EVENT, &f);
+}
+
 gboolean
 p2t_sweep_is_edge_side_of_triangle (P2tSweep *THIS, P2tTriangle *triangle, P2tPoint* ep, P2tPoint* eq)
 {
@@ -256,19 +583,15 @@ p2t_sweep_is_edge_side_of_triangle (P2tSweep *THIS, P2tTriangle *triangle, P2tPo
 P2tNode*
 p2t_sweep_new_front_triangle (P2tSweep *THIS, P2tSweepContext *tcx, P2tPoint* point, P2tNode *node)
 {
-  P2tTriangle* triangle = p2t_triangle_new (point, node->point, node->next->point);
+  P2tTriangle* triangle = p2t_sweepcontext_new_triangle (tcx, point, node->point, node->next->point);
   P2tNode *new_node;
 
   p2t_triangle_mark_neighbor_tr (triangle, node->triangle);
   p2t_sweepcontext_add_to_map (tcx, triangle);
 
-  new_node = p2t_node_new_pt (point);
-  g_ptr_array_add (THIS->nodes_, new_node);
+  new_node = p2t_sweepcontext_new_node (tcx, point, NULL);
 
-  new_node->next = node->next;
-  new_node->prev = node;
-  node->next->prev = new_node;
-  node->next = new_node;
+  p2t_advancingfront_insert (p2t_sweepcontext_front (tcx), node, new_node);
 
   if (!p2t_sweep_legalize (THIS, tcx, triangle))
     {
@@ -281,7 +604,7 @@ p2t_sweep_new_front_triangle (P2tSweep *THIS, P2tSweepContext *tcx, P2tPoint* po
 void
 p2t_sweep_fill (P2tSweep *THIS, P2tSweepContext *tcx, P2tNode* node)
 {
-  P2tTriangle* triangle = p2t_triangle_new (node->prev->point, node->point, node->next->point);
+  P2tTriangle* triangle = p2t_sweepcontext_new_triangle (tcx, node->prev->point, node->point, node->next->point);
 
   /* TODO: should copy the constrained_edge value from neighbor triangles
    *       for now constrained_edge values are copied during the legalize */
@@ -291,8 +614,7 @@ p2t_sweep_fill (P2tSweep *THIS, P2tSweepContext *tcx, P2tNode* node)
   p2t_sweepcontext_add_to_map (tcx, triangle);
 
   /* Update the advancing front */
-  node->prev->next = node->next;
-  node->next->prev = node->prev;
+  p2t_advancingfront_remove (p2t_sweepcontext_front (tcx), node);
 
   /* If it was legalized the triangle has already been mapped */
   if (!p2t_sweep_legalize (THIS, tcx, triangle))
@@ -427,9 +749,12 @@ p2t_sweep_hole_angle (P2tSweep *THIS, P2tNode* node)
   return atan2 (ax * by - ay * bx, ax * bx + ay * by);
 }
 
-gboolean
-p2t_sweep_legalize (P2tSweep *THIS, P2tSweepContext *tcx, P2tTriangle *t)
+/* Looks for an edge of the triangle of @frame which violates the Delaunay
+ * condition, and flips it. Returns FALSE if there is no such edge */
+static gboolean
+p2t_sweep_legalize_edge (P2tSweep *THIS, P2tSweepLegalizeFrame *frame)
 {
+  P2tTriangle *t = frame->t;
   int i;
   /* To legalize a triangle we start by finding if any of the three edges
    * violate the Delaunay condition */
@@ -437,7 +762,7 @@ p2t_sweep_legalize (P2tSweep *THIS, P2tSweepContext *tcx, P2tTriangle *t)
     {
       P2tTriangle *ot;
 
-      if (t->delaunay_edge[i])
+      if (p2t_triangle_get_delaunay_edge (t, i))
         continue;
 
       ot = p2t_triangle_get_neighbor (t, i);
@@ -451,9 +776,9 @@ p2t_sweep_legalize (P2tSweep *THIS, P2tSweepContext *tcx, P2tTriangle *t)
 
           /* If this is a Constrained Edge or a Delaunay Edge(only during recursive legalization)
            * then we should not try to legalize */
-          if (ot->constrained_edge[oi] || ot->delaunay_edge[oi])
+          if (p2t_triangle_get_constrained_edge (ot, oi) || p2t_triangle_get_delaunay_edge (ot, oi))
             {
-              t->constrained_edge[i] = ot->constrained_edge[oi];
+              p2t_triangle_set_constrained_edge (t, i, p2t_triangle_get_constrained_edge (ot, oi));
               continue;
             }
 
@@ -461,37 +786,16 @@ p2t_sweep_legalize (P2tSweep *THIS, P2tSweepContext *tcx, P2tTriangle *t)
 
           if (inside)
             {
-              gboolean not_legalized;
               /* Lets mark this shared edge as Delaunay */
-              t->delaunay_edge[i] = TRUE;
-              ot->delaunay_edge[oi] = TRUE;
+              p2t_triangle_set_delaunay_edge (t, i, TRUE);
+              p2t_triangle_set_delaunay_edge (ot, oi, TRUE);
 
               /* Lets rotate shared edge one vertex CW to legalize it */
               p2t_sweep_rotate_triangle_pair (THIS, t, p, ot, op);
 
-              /* We now got one valid Delaunay Edge shared by two triangles
-               * This gives us 4 new edges to check for Delaunay */
-
-              /* Make sure that triangle to node mapping is done only one time for a specific triangle */
-              not_legalized = !p2t_sweep_legalize (THIS, tcx, t);
-              if (not_legalized)
-                {
-                  p2t_sweepcontext_map_triangle_to_nodes (tcx, t);
-                }
-
-              not_legalized = !p2t_sweep_legalize (THIS, tcx, ot);
-              if (not_legalized)
-                p2t_sweepcontext_map_triangle_to_nodes (tcx, ot);
-
-              /* Reset the Delaunay edges, since they only are valid Delaunay edges
-               * until we add a new triangle or point.
-               * XXX: need to think about this. Can these edges be tried after we
-               *      return to previous recursive level? */
-              t->delaunay_edge[i] = FALSE;
-              ot->delaunay_edge[oi] = FALSE;
-
-              /* If triangle have been legalized no need to check the other edges since
-               * the recursive legalization will handles those so we can end here.*/
+              frame->ot = ot;
+              frame->i = i;
+              frame->oi = oi;
               return TRUE;
             }
         }
@@ -499,48 +803,88 @@ p2t_sweep_legalize (P2tSweep *THIS, P2tSweepContext *tcx, P2tTriangle *t)
   return FALSE;
 }
 
-gboolean
-p2t_sweep_incircle (P2tSweep *THIS, P2tPoint* pa, P2tPoint* pb, P2tPoint* pc, P2tPoint* pd)
+static void
+p2t_sweep_legalize_push (GArray *stack, P2tTriangle *t)
 {
-  double adx = pa->x - pd->x;
-  double ady = pa->y - pd->y;
-  double bdx = pb->x - pd->x;
-  double bdy = pb->y - pd->y;
+  P2tSweepLegalizeFrame frame;
+  frame.t = t;
+  frame.ot = NULL;
+  frame.i = frame.oi = 0;
+  frame.state = P2T_SWEEP_LEGALIZE_START;
+  g_array_append_val (stack, frame);
+}
 
-  double adxbdy = adx * bdy;
-  double bdxady = bdx * ady;
-  double oabd = adxbdy - bdxady;
+gboolean
+p2t_sweep_legalize (P2tSweep *THIS, P2tSweepContext *tcx, P2tTriangle *t)
+{
+  GArray *stack = THIS->legalize_stack_;
+  guint base = stack->len;
+  /* The result of the last legalization which was completed */
+  gboolean legalized = FALSE;
 
-  double cdx, cdy;
-  double cdxady, adxcdy, ocad;
+  p2t_sweep_legalize_push (stack, t);
+  while (stack->len > base)
+    {
+      P2tSweepLegalizeFrame *frame = &g_array_index (stack, P2tSweepLegalizeFrame, stack->len - 1);
 
-  double bdxcdy, cdxbdy;
-  double alift, blift, clift;
-  double det;
+      switch (frame->state)
+        {
+        case P2T_SWEEP_LEGALIZE_START:
+          if (p2t_sweep_legalize_edge (THIS, frame))
+            {
+              /* We now got one valid Delaunay Edge shared by two triangles
+               * This gives us 4 new edges to check for Delaunay */
+              frame->state = P2T_SWEEP_LEGALIZE_AFTER_T;
+              p2t_sweep_legalize_push (stack, frame->t);
+            }
+          else
+            {
+              g_array_set_size (stack, stack->len - 1);
+              legalized = FALSE;
+            }
+          break;
+
+        case P2T_SWEEP_LEGALIZE_AFTER_T:
+          /* Make sure that triangle to node mapping is done only one time for a specific triangle */
+          if (! legalized)
+            p2t_sweepcontext_map_triangle_to_nodes (tcx, frame->t);
+          frame->state = P2T_SWEEP_LEGALIZE_AFTER_OT;
+          p2t_sweep_legalize_push (stack, frame->ot);
+          break;
+
+        case P2T_SWEEP_LEGALIZE_AFTER_OT:
+          if (! legalized)
+            p2t_sweepcontext_map_triangle_to_nodes (tcx, frame->ot);
+
+          /* Reset the Delaunay edges, since they only are valid Delaunay edges
+           * until we add a new triangle or point.
+           * XXX: need to think about this. Can these edges be tried after we
+           *      return to previous recursive level? */
+          p2t_triangle_set_delaunay_edge (frame->t, frame->i, FALSE);
+          p2t_triangle_set_delaunay_edge (frame->ot, frame->oi, FALSE);
+
+          /* If triangle have been legalized no need to check the other edges since
+           * the recursive legalization will handles those so we can end here.*/
+          g_array_set_size (stack, stack->len - 1);
+          legalized = TRUE;
+          break;
+        }
+    }
+  return legalized;
+}
 
-  if (oabd <= 0)
+gboolean
+p2t_sweep_incircle (P2tSweep *THIS, P2tPoint* pa, P2tPoint* pb, P2tPoint* pc, P2tPoint* pd)
+{
+  /* oabd = orient2d (a, b, d) */
+  if (p2t_predicates_orient2d (pa->x, pa->y, pb->x, pb->y, pd->x, pd->y) <= 0)
     return FALSE;
 
-  cdx = pc->x - pd->x;
-  cdy = pc->y - pd->y;
-
-  cdxady = cdx * ady;
-  adxcdy = adx * cdy;
-  ocad = cdxady - adxcdy;
-
-  if (ocad <= 0)
+  /* ocad = orient2d (c, a, d) */
+  if (p2t_predicates_orient2d (pc->x, pc->y, pa->x, pa->y, pd->x, pd->y) <= 0)
     return FALSE;
 
-  bdxcdy = bdx * cdy;
-  cdxbdy = cdx * bdy;
-
-  alift = adx * adx + ady * ady;
-  blift = bdx * bdx + bdy * bdy;
-  clift = cdx * cdx + cdy * cdy;
-
-  det = alift * (bdxcdy - cdxbdy) + blift * ocad + clift * oabd;
-
-  return det > 0;
+  return p2t_predicates_incircle (pa->x, pa->y, pb->x, pb->y, pc->x, pc->y, pd->x, pd->y) > 0;
 }
 
 void
@@ -641,49 +985,45 @@ void
 p2t_sweep_fill_basin_req (P2tSweep *THIS, P2tSweepContext *tcx, P2tNode* node)
 {
   /* if shallow stop filling */
-  if (p2t_sweep_is_shallow (THIS, tcx, node))
+  while (! p2t_sweep_is_shallow (THIS, tcx, node))
     {
-      return;
-    }
-
-  p2t_sweep_fill (THIS, tcx, node);
+      p2t_sweep_fill (THIS, tcx, node);
 
-  if (node->prev == tcx->basin.left_node && node->next == tcx->basin.right_node)
-    {
-      return;
-    }
-  else if (node->prev == tcx->basin.left_node)
-    {
-      P2tOrientation o = p2t_orient2d (node->point, node->next->point, node->next->next->point);
-      if (o == CW)
+      if (node->prev == tcx->basin.left_node && node->next == tcx->basin.right_node)
         {
           return;
         }
-      node = node->next;
-    }
-  else if (node->next == tcx->basin.right_node)
-    {
-      P2tOrientation o = p2t_orient2d (node->point, node->prev->point, node->prev->prev->point);
-      if (o == CCW)
+      else if (node->prev == tcx->basin.left_node)
         {
-          return;
+          P2tOrientation o = p2t_orient2d (node->point, node->next->point, node->next->next->point);
+          if (o == CW)
+            {
+              return;
+            }
+          node = node->next;
         }
-      node = node->prev;
-    }
-  else
-    {
-      /* Continue with the neighbor node with lowest Y value */
-      if (node->prev->point->y < node->next->point->y)
+      else if (node->next == tcx->basin.right_node)
         {
+          P2tOrientation o = p2t_orient2d (node->point, node->prev->point, node->prev->prev->point);
+          if (o == CCW)
+            {
+              return;
+            }
           node = node->prev;
         }
       else
         {
-          node = node->next;
+          /* Continue with the neighbor node with lowest Y value */
+          if (node->prev->point->y < node->next->point->y)
+            {
+              node = node->prev;
+            }
+          else
+            {
+              node = node->next;
+            }
         }
     }
-
-  p2t_sweep_fill_basin_req (THIS, tcx, node);
 }
 
 gboolean
@@ -741,70 +1081,61 @@ p2t_sweep_fill_right_above_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2t
 void
 p2t_sweep_fill_right_below_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2tEdge* edge, P2tNode* node)
 {
-  if (node->point->x < edge->p->x)
+  while (node->point->x < edge->p->x)
     {
       if (p2t_orient2d (node->point, node->next->point, node->next->next->point) == CCW)
         {
           /* Concave */
           p2t_sweep_fill_right_concave_edge_event (THIS, tcx, edge, node);
+          return;
         }
-      else
-        {
-          /* Convex */
-          p2t_sweep_fill_right_convex_edge_event (THIS, tcx, edge, node);
-          /* Retry this one */
-          p2t_sweep_fill_right_below_edge_event (THIS, tcx, edge, node);
-        }
+      /* Convex */
+      p2t_sweep_fill_right_convex_edge_event (THIS, tcx, edge, node);
+      /* Retry this one */
     }
 }
 
 void
 p2t_sweep_fill_right_concave_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2tEdge* edge, P2tNode* node)
 {
-  p2t_sweep_fill (THIS, tcx, node->next);
-  if (node->next->point != edge->p)
+  while (TRUE)
     {
+      p2t_sweep_fill (THIS, tcx, node->next);
+      if (node->next->point == edge->p)
+        return;
+
       /* Next above or below edge? */
-      if (p2t_orient2d (edge->q, node->next->point, edge->p) == CCW)
+      if (p2t_orient2d (edge->q, node->next->point, edge->p) != CCW)
+        return;
+
+      /* Below */
+      if (p2t_orient2d (node->point, node->next->point, node->next->next->point) != CCW)
         {
-          /* Below */
-          if (p2t_orient2d (node->point, node->next->point, node->next->next->point) == CCW)
-            {
-              /* Next is concave */
-              p2t_sweep_fill_right_concave_edge_event (THIS, tcx, edge, node);
-            }
-          else
-            {
-              /* Next is convex */
-            }
+          /* Next is convex */
+          return;
         }
+      /* Next is concave */
     }
-
 }
 
 void
 p2t_sweep_fill_right_convex_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2tEdge* edge, P2tNode* node)
 {
   /* Next concave or convex? */
-  if (p2t_orient2d (node->next->point, node->next->next->point, node->next->next->next->point) == CCW)
-    {
-      /* Concave */
-      p2t_sweep_fill_right_concave_edge_event (THIS, tcx, edge, node->next);
-    }
-  else
+  while (p2t_orient2d (node->next->point, node->next->next->point, node->next->next->next->point) != CCW)
     {
       /* Convex
        * Next above or below edge? */
-      if (p2t_orient2d (edge->q, node->next->next->point, edge->p) == CCW)
-        {
-          /* Below */
-          p2t_sweep_fill_right_convex_edge_event (THIS, tcx, edge, node->next);
-        }
-      else
+      if (p2t_orient2d (edge->q, node->next->next->point, edge->p) != CCW)
         {
           /* Above */
+          return;
         }
+      /* Below */
+      node = node->next;
     }
+  /* Concave */
+  p2t_sweep_fill_right_concave_edge_event (THIS, tcx, edge, node->next);
 }
 
 void
@@ -827,20 +1158,17 @@ p2t_sweep_fill_left_above_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2tE
 void
 p2t_sweep_fill_left_below_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2tEdge* edge, P2tNode* node)
 {
-  if (node->point->x > edge->p->x)
+  while (node->point->x > edge->p->x)
     {
       if (p2t_orient2d (node->point, node->prev->point, node->prev->prev->point) == CW)
         {
           /* Concave */
           p2t_sweep_fill_left_concave_edge_event (THIS, tcx, edge, node);
+          return;
         }
-      else
-        {
-          /* Convex */
-          p2t_sweep_fill_left_convex_edge_event (THIS, tcx, edge, node);
-          /* Retry this one */
-          p2t_sweep_fill_left_below_edge_event (THIS, tcx, edge, node);
-        }
+      /* Convex */
+      p2t_sweep_fill_left_convex_edge_event (THIS, tcx, edge, node);
+      /* Retry this one */
     }
 }
 
@@ -848,100 +1176,55 @@ void
 p2t_sweep_fill_left_convex_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2tEdge* edge, P2tNode* node)
 {
   /* Next concave or convex? */
-  if (p2t_orient2d (node->prev->point, node->prev->prev->point, node->prev->prev->prev->point) == CW)
-    {
-      /* Concave */
-      p2t_sweep_fill_left_concave_edge_event (THIS, tcx, edge, node->prev);
-    }
-  else
+  while (p2t_orient2d (node->prev->point, node->prev->prev->point, node->prev->prev->prev->point) != CW)
     {
       /* Convex
        * Next above or below edge? */
-      if (p2t_orient2d (edge->q, node->prev->prev->point, edge->p) == CW)
-        {
-          /* Below */
-          p2t_sweep_fill_left_convex_edge_event (THIS, tcx, edge, node->prev);
-        }
-      else
+      if (p2t_orient2d (edge->q, node->prev->prev->point, edge->p) != CW)
         {
           /* Above */
+          return;
         }
+      /* Below */
+      node = node->prev;
     }
+  /* Concave */
+  p2t_sweep_fill_left_concave_edge_event (THIS, tcx, edge, node->prev);
 }
 
 void
 p2t_sweep_fill_left_concave_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2tEdge* edge, P2tNode* node)
 {
-  p2t_sweep_fill (THIS, tcx, node->prev);
-  if (node->prev->point != edge->p)
+  while (TRUE)
     {
+      p2t_sweep_fill (THIS, tcx, node->prev);
+      if (node->prev->point == edge->p)
+        return;
+
       /* Next above or below edge? */
-      if (p2t_orient2d (edge->q, node->prev->point, edge->p) == CW)
+      if (p2t_orient2d (edge->q, node->prev->point, edge->p) != CW)
+        return;
+
+      /* Below */
+      if (p2t_orient2d (node->point, node->prev->point, node->prev->prev->point) != CW)
         {
-          /* Below */
-          if (p2t_orient2d (node->point, node->prev->point, node->prev->prev->point) == CW)
-            {
-              /* Next is concave */
-              p2t_sweep_fill_left_concave_edge_event (THIS, tcx, edge, node);
-            }
-          else
-            {
-              /* Next is convex */
-            }
+          /* Next is convex */
+          return;
         }
+      /* Next is concave */
     }
-
 }
 
 void
 p2t_sweep_flip_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2tPoint* ep, P2tPoint* eq, P2tTriangle* t, P2tPoint* p)
 {
-  P2tTriangle* ot = p2t_triangle_neighbor_across (t, p);
-  P2tPoint* op = p2t_triangle_opposite_point (ot, t, p);
-
-  if (ot == NULL)
-    {
-      /* If we want to integrate the fillEdgeEvent do it here
-       * With current implementation we should never get here
-       *throw new RuntimeException( "[BUG:FIXME] FLIP failed due to missing triangle");
-       */
-      assert (0);
-    }
-
-  if (p2t_utils_in_scan_area (p, p2t_triangle_point_ccw (t, p), p2t_triangle_point_cw (t, p), op))
-    {
-      /* Lets rotate shared edge one vertex CW */
-      p2t_sweep_rotate_triangle_pair (THIS, t, p, ot, op);
-      p2t_sweepcontext_map_triangle_to_nodes (tcx, t);
-      p2t_sweepcontext_map_triangle_to_nodes (tcx, ot);
-
-      if (p == eq && op == ep)
-        {
-          if (p2t_point_equals (eq, tcx->edge_event.constrained_edge->q) && p2t_point_equals (ep, tcx->edge_event.constrained_edge->p))
-            {
-              p2t_triangle_mark_constrained_edge_pt_pt (t, ep, eq);
-              p2t_triangle_mark_constrained_edge_pt_pt (ot, ep, eq);
-              p2t_sweep_legalize (THIS, tcx, t);
-              p2t_sweep_legalize (THIS, tcx, ot);
-            }
-          else
-            {
-              /* XXX: I think one of the triangles should be legalized here? */
-            }
-        }
-      else
-        {
-          P2tOrientation o = p2t_orient2d (eq, op, ep);
-          t = p2t_sweep_next_flip_triangle (THIS, tcx, (int) o, t, ot, p, op);
-          p2t_sweep_flip_edge_event (THIS, tcx, ep, eq, t, p);
-        }
-    }
-  else
-    {
-      P2tPoint* newP = p2t_sweep_next_flip_point (THIS, ep, eq, ot, op);
-      p2t_sweep_flip_scan_edge_event (THIS, tcx, ep, eq, t, ot, newP);
-      p2t_sweep_edge_event_pt_pt_tr_pt (THIS, tcx, ep, eq, t, p);
-    }
+  P2tSweepEdgeEventFrame f;
+  f.ep = ep;
+  f.eq = eq;
+  f.flip_triangle = NULL;
+  f.t = t;
+  f.p = p;
+  p2t_sweep_run_edge_event (THIS, tcx, P2T_SWEEP_FLIP_EDGE_EVENT, &f);
 }
 
 P2tTriangle*
@@ -953,7 +1236,7 @@ p2t_sweep_next_flip_triangle (P2tSweep *THIS, P2tSweepContext *tcx, int o, P2tTr
     {
       /* ot is not crossing edge after flip */
       int edge_index = p2t_triangle_edge_index (ot, p, op);
-      ot->delaunay_edge[edge_index] = TRUE;
+      p2t_triangle_set_delaunay_edge (ot, edge_index, TRUE);
       p2t_sweep_legalize (THIS, tcx, ot);
       p2t_triangle_clear_delunay_edges (ot);
       return t;
@@ -962,7 +1245,7 @@ p2t_sweep_next_flip_triangle (P2tSweep *THIS, P2tSweepContext *tcx, int o, P2tTr
   /* t is not crossing edge after flip */
   edge_index = p2t_triangle_edge_index (t, p, op);
 
-  t->delaunay_edge[edge_index] = TRUE;
+  p2t_triangle_set_delaunay_edge (t, edge_index, TRUE);
   p2t_sweep_legalize (THIS, tcx, t);
   p2t_triangle_clear_delunay_edges (t);
   return ot;
@@ -994,33 +1277,11 @@ void
 p2t_sweep_flip_scan_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2tPoint* ep, P2tPoint* eq, P2tTriangle *flip_triangle,
                                 P2tTriangle *t, P2tPoint* p)
 {
-  P2tTriangle* ot = p2t_triangle_neighbor_across (t, p);
-  P2tPoint* op = p2t_triangle_opposite_point (ot, t, p);
-
-  if (p2t_triangle_neighbor_across (t, p) == NULL)
-    {
-      /* If we want to integrate the fillEdgeEvent do it here
-       * With current implementation we should never get here
-       *throw new RuntimeException( "[BUG:FIXME] FLIP failed due to missing triangle");
-       */
-      assert (0);
-    }
-
-  if (p2t_utils_in_scan_area (eq, p2t_triangle_point_ccw (flip_triangle, eq), p2t_triangle_point_cw (flip_triangle, eq), op))
-    {
-      /* flip with new edge op->eq */
-      p2t_sweep_flip_edge_event (THIS, tcx, eq, op, ot, op);
-      /* TODO: Actually I just figured out that it should be possible to
-       *       improve this by getting the next ot and op before the the above
-       *       flip and continue the flipScanEdgeEvent here
-       * set new ot and op here and loop back to inScanArea test
-       * also need to set a new flip_triangle first
-       * Turns out at first glance that this is somewhat complicated
-       * so it will have to wait. */
-    }
-  else
-    {
-      P2tPoint* newP = p2t_sweep_next_flip_point (THIS, ep, eq, ot, op);
-      p2t_sweep_flip_scan_edge_event (THIS, tcx, ep, eq, flip_triangle, ot, newP);
-    }
+  P2tSweepEdgeEventFrame f;
+  f.ep = ep;
+  f.eq = eq;
+  f.flip_triangle = flip_triangle;
+  f.t = t;
+  f.p = p;
+  p2t_sweep_run_edge_event (THIS, tcx, P2T_SWEEP_FLIP_SCAN_EDGE_EVENT, &f);
 }
@@ -46,11 +46,26 @@
 
 #include "../common/poly2tri-private.h"
 #include "../common/shapes.h"
+#include "insert.h"
+#include "monotone.h"
+#include "slabs.h"
 
 struct Sweep_
 {
 /* private: */
-P2tNodePtrArray nodes_;
+/* Work stacks replacing the recursion of the legalization and of the
+ * flip edge events. They are emptied, but not freed, after every call so
+ * their storage is reused by the following triangulations */
+GArray* legalize_stack_;
+GArray* edge_event_stack_;
+/* The triangles waiting to be checked by the Delaunay flip pass */
+GPtrArray* flip_stack_;
+/* The triangulation of convex and monotone polygons */
+P2tMonotone monotone_;
+/* The edits of the triangulation after the sweep */
+P2tInsert insert_;
+/* The parallel sweep of large inputs */
+P2tSlabs slabs_;
 
 };
 
@@ -279,4 +294,63 @@ void p2t_sweep_flip_scan_edge_event (P2tSweep *THIS, P2tSweepContext *tcx, P2tPo
 
 void p2t_sweep_finalization_polygon (P2tSweep *THIS, P2tSweepContext *tcx);
 
+/**
+ * Collect the triangles inside the convex hull of a point cloud
+ *
+ * @param tcx
+ */
+void p2t_sweep_finalization_point_cloud (P2tSweep *THIS, P2tSweepContext *tcx);
+
+/**
+ * Flip the unconstrained edges between the triangles of the result until
+ * all of them are locally Delaunay. The sweep alone does not guarantee it
+ * near the artificial points and around the flipped constraint edges
+ *
+ * @param tcx
+ */
+void p2t_sweep_delaunay_flip (P2tSweep *THIS, P2tSweepContext *tcx);
+
+/**
+ * Flip like p2t_sweep_delaunay_flip(), but check only the edges of the
+ * given triangles (and those of the triangles which are flipped). This is
+ * enough when all the other edges are known to be locally Delaunay
+ *
+ * @param triangles Interior triangles
+ */
+void p2t_sweep_delaunay_flip_triangles (P2tSweep *THIS, P2tTrianglePtrArray triangles);
+
+/**
+ * Insert a Steiner point into the triangulation, changing only the
+ * triangles around it (see #p2t_insert_point)
+ *
+ * @param tcx A triangulated sweep context
+ * @param point
+ * @param hint A triangle close to the point, or NULL
+ * @return A triangle which has the point as a vertex, or NULL if the point
+ *         was not inserted
+ */
+P2tTriangle* p2t_sweep_insert_point (P2tSweep *THIS, P2tSweepContext *tcx, P2tPoint *point, P2tTriangle *hint);
+
+/**
+ * Insert a hole into the triangulation, changing only the triangles around
+ * and inside it (see #p2t_insert_hole)
+ *
+ * @param tcx A triangulated sweep context
+ * @param polyline
+ * @return FALSE if the hole was not inserted
+ */
+gboolean p2t_sweep_insert_hole (P2tSweep *THIS, P2tSweepContext *tcx, P2tPointPtrArray polyline);
+
+/**
+ * Make the edge between two vertices of the triangulation a constraint
+ * edge, changing only the triangles which it crosses (see #p2t_insert_edge)
+ *
+ * @param tcx A triangulated sweep context
+ * @param p
+ * @param q
+ * @param hint A triangle close to p, or NULL
+ * @return A triangle close to p
+ */
+P2tTriangle* p2t_sweep_insert_edge (P2tSweep *THIS, P2tSweepContext *tcx, P2tPoint *p, P2tPoint *q, P2tTriangle *hint);
+
 #endif
@@ -33,8 +33,12 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <string.h>
+
 #include "sweep_context.h"
 #include "advancing_front.h"
+#include "../common/predicates.h"
+#include "../common/sort.h"
 
 void
 p2t_sweepcontext_basin_init (P2tSweepContextBasin* THIS)
@@ -59,31 +63,121 @@ p2t_sweepcontext_edgeevent_init (P2tSweepContextEdgeEvent* THIS)
   THIS->right = FALSE;
 }
 
-void
-p2t_sweepcontext_init (P2tSweepContext* THIS, P2tPointPtrArray polyline)
+/* Add an input point, remembering its position in the input order */
+static void
+p2t_sweepcontext_add_input_point (P2tSweepContext* THIS, P2tPoint* point)
+{
+  point->index_ = THIS->points_->len;
+  g_ptr_array_add (THIS->points_, point);
+}
+
+static void
+p2t_sweepcontext_add_ring (P2tSweepContext* THIS, guint start, guint length)
+{
+  P2tSweepContextRing ring;
+
+  ring.start = start;
+  ring.length = length;
+  ring.interior_left = TRUE;
+  g_array_append_val (THIS->rings_, ring);
+}
+
+/* Start over with the given polyline. Everything which the input and the
+ * previous triangulation left in the (already allocated) containers is
+ * dropped */
+static void
+p2t_sweepcontext_set_polyline (P2tSweepContext* THIS, P2tPointPtrArray polyline, gboolean point_cloud)
 {
   guint i;
 
-  THIS->front_ = NULL;
-  THIS->head_ = NULL;
-  THIS->tail_ = NULL;
+  THIS->point_cloud_ = point_cloud;
+  THIS->polyline_length_ = polyline->len;
 
   THIS->af_head_ = NULL;
   THIS->af_middle_ = NULL;
   THIS->af_tail_ = NULL;
 
-  THIS->edge_list = g_ptr_array_new ();
-  THIS->triangles_ = g_ptr_array_new ();
-  THIS->map_ = NULL;
+  g_array_set_size (THIS->edge_list, 0);
+  g_ptr_array_set_size (THIS->triangles_, 0);
+  g_ptr_array_set_size (THIS->map_, 0);
+  g_ptr_array_set_size (THIS->points_, 0);
+  g_array_set_size (THIS->rings_, 0);
 
   p2t_sweepcontext_basin_init (&THIS->basin);
   p2t_sweepcontext_edgeevent_init (&THIS->edge_event);
 
-  THIS->points_ = g_ptr_array_sized_new (polyline->len);
   for (i = 0; i < polyline->len; i++)
-    g_ptr_array_add (THIS->points_, point_index (polyline, i));
+    p2t_sweepcontext_add_input_point (THIS, point_index (polyline, i));
+
+  /* The edges of a point cloud are those of its convex hull, which are
+   * only known once the points are sorted */
+  if (! point_cloud)
+    {
+      p2t_sweepcontext_add_ring (THIS, 0, polyline->len);
+      p2t_sweepcontext_init_edges (THIS, THIS->points_);
+    }
+}
+
+static void
+p2t_sweepcontext_init_full (P2tSweepContext* THIS, P2tPointPtrArray polyline, gboolean point_cloud)
+{
+  p2t_arena_init (&THIS->arena_, P2T_SWEEPCONTEXT_ARENA_BLOCK_SIZE);
+
+  THIS->front_ = NULL;
+  THIS->head_ = NULL;
+  THIS->tail_ = NULL;
+
+  THIS->edge_list = g_array_new (FALSE, FALSE, sizeof (P2tEdge));
+  THIS->edges_ = NULL;
+  THIS->edge_offsets_ = NULL;
+  THIS->edges_size_ = 0;
+  THIS->edge_offsets_size_ = 0;
+  THIS->triangles_ = g_ptr_array_new ();
+  THIS->map_ = g_ptr_array_new ();
+  THIS->points_ = g_ptr_array_sized_new (polyline->len);
+
+  THIS->presorted_ = FALSE;
+  THIS->sort_threads_ = 1;
+  THIS->sweep_threads_ = 1;
+  THIS->front_index_ = FALSE;
+  THIS->monotone_mode_ = P2T_MONOTONE_AUTO;
+
+  THIS->sort_scratch_ = g_byte_array_new ();
+  THIS->rings_ = g_array_new (FALSE, FALSE, sizeof (P2tSweepContextRing));
+  THIS->input_ = g_ptr_array_new ();
+  THIS->hull_ = g_ptr_array_new ();
+  THIS->parts_ = g_ptr_array_new ();
+
+  p2t_sweepcontext_set_polyline (THIS, polyline, point_cloud);
+}
+
+void
+p2t_sweepcontext_init (P2tSweepContext* THIS, P2tPointPtrArray polyline)
+{
+  p2t_sweepcontext_init_full (THIS, polyline, FALSE);
+}
 
-  p2t_sweepcontext_init_edges (THIS, THIS->points_);
+void
+p2t_sweepcontext_init_point_cloud (P2tSweepContext* THIS, P2tPointPtrArray points)
+{
+  p2t_sweepcontext_init_full (THIS, points, TRUE);
+}
+
+void
+p2t_sweepcontext_reset (P2tSweepContext* THIS, P2tPointPtrArray polyline)
+{
+  /* The triangles and the nodes of the previous triangulation */
+  p2t_arena_reset (&THIS->arena_);
+
+  p2t_sweepcontext_set_polyline (THIS, polyline, FALSE);
+}
+
+void
+p2t_sweepcontext_reset_point_cloud (P2tSweepContext* THIS, P2tPointPtrArray points)
+{
+  p2t_arena_reset (&THIS->arena_);
+
+  p2t_sweepcontext_set_polyline (THIS, points, TRUE);
 }
 
 P2tSweepContext*
@@ -94,38 +188,44 @@ p2t_sweepcontext_new (P2tPointPtrArray polyline)
   return THIS;
 }
 
+P2tSweepContext*
+p2t_sweepcontext_new_point_cloud (P2tPointPtrArray points)
+{
+  P2tSweepContext* THIS = g_new (P2tSweepContext, 1);
+  p2t_sweepcontext_init_point_cloud (THIS, points);
+  return THIS;
+}
+
 void
 p2t_sweepcontext_destroy (P2tSweepContext* THIS)
 {
-  GList* iter;
   guint i;
+
   /* Clean up memory */
 
   p2t_point_free (THIS->head_);
   p2t_point_free (THIS->tail_);
-  p2t_advancingfront_free (THIS->front_);
-  p2t_node_free (THIS->af_head_);
-  p2t_node_free (THIS->af_middle_);
-  p2t_node_free (THIS->af_tail_);
+  /* There is no front if the points were never swept */
+  if (THIS->front_ != NULL)
+    p2t_advancingfront_free (THIS->front_);
 
   g_ptr_array_free (THIS->points_, TRUE);
   g_ptr_array_free (THIS->triangles_, TRUE);
-
-  for (iter = g_list_first (THIS->map_); iter != NULL; iter = g_list_next (iter))
-    {
-      P2tTriangle* ptr = triangle_val (iter);
-      g_free (ptr);
-    }
-
-  g_list_free (THIS->map_);
-
-  for (i = 0; i < THIS->edge_list->len; i++)
-    {
-      p2t_edge_free (edge_index (THIS->edge_list, i));
-    }
-
-  g_ptr_array_free (THIS->edge_list, TRUE);
-
+  g_ptr_array_free (THIS->map_, TRUE);
+  g_array_free (THIS->edge_list, TRUE);
+  g_free (THIS->edges_);
+  g_free (THIS->edge_offsets_);
+  g_byte_array_free (THIS->sort_scratch_, TRUE);
+  g_array_free (THIS->rings_, TRUE);
+  g_ptr_array_free (THIS->input_, TRUE);
+  g_ptr_array_free (THIS->hull_, TRUE);
+
+  for (i = 0; i < THIS->parts_->len; i++)
+    p2t_sweepcontext_delete ((P2tSweepContext*) g_ptr_array_index (THIS->parts_, i));
+  g_ptr_array_free (THIS->parts_, TRUE);
+
+  /* Triangles and nodes all live in the arena */
+  p2t_arena_destroy (&THIS->arena_);
 }
 
 void
@@ -139,17 +239,21 @@ void
 p2t_sweepcontext_add_hole (P2tSweepContext *THIS, P2tPointPtrArray polyline)
 {
   guint i;
+
+  g_return_if_fail (! THIS->point_cloud_);
+
+  p2t_sweepcontext_add_ring (THIS, THIS->points_->len, polyline->len);
   p2t_sweepcontext_init_edges (THIS, polyline);
   for (i = 0; i < polyline->len; i++)
     {
-      g_ptr_array_add (THIS->points_, point_index (polyline, i));
+      p2t_sweepcontext_add_input_point (THIS, point_index (polyline, i));
     }
 }
 
 void
 p2t_sweepcontext_add_point (P2tSweepContext *THIS, P2tPoint* point)
 {
-  g_ptr_array_add (THIS->points_, point);
+  p2t_sweepcontext_add_input_point (THIS, point);
 }
 
 P2tTrianglePtrArray
@@ -158,20 +262,194 @@ p2t_sweepcontext_get_triangles (P2tSweepContext *THIS)
   return THIS->triangles_;
 }
 
-P2tTrianglePtrList
+P2tTrianglePtrArray
 p2t_sweepcontext_get_map (P2tSweepContext *THIS)
 {
   return THIS->map_;
 }
 
-void
+/* Group the constraint edges by their upper point, with a counting sort
+ * over the input index of the points. This keeps the order in which the
+ * edges of each point were added */
+static void
+p2t_sweepcontext_init_point_edges (P2tSweepContext *THIS)
+{
+  guint n_points = THIS->points_->len;
+  guint n_edges = THIS->edge_list->len;
+  guint *offsets;
+  P2tEdge *edges;
+  guint i;
+
+  /* Grow the tables when needed, keeping them between resets */
+  if (THIS->edge_offsets_size_ < n_points + 1)
+    {
+      THIS->edge_offsets_size_ = n_points + 1;
+      THIS->edge_offsets_ = g_renew (guint, THIS->edge_offsets_, THIS->edge_offsets_size_);
+    }
+  if (THIS->edges_size_ < n_edges)
+    {
+      THIS->edges_size_ = n_edges;
+      THIS->edges_ = g_renew (P2tEdge, THIS->edges_, THIS->edges_size_);
+    }
+
+  offsets = THIS->edge_offsets_;
+  edges = THIS->edges_;
+  memset (offsets, 0, (n_points + 1) * sizeof (guint));
+
+  for (i = 0; i < n_edges; i++)
+    offsets[g_array_index (THIS->edge_list, P2tEdge, i).q->index_ + 1]++;
+
+  for (i = 0; i < n_points; i++)
+    offsets[i + 1] += offsets[i];
+
+  /* Use the start offsets as insertion cursors, and shift them back
+   * once all the edges are in place */
+  for (i = 0; i < n_edges; i++)
+    {
+      P2tEdge *edge = &g_array_index (THIS->edge_list, P2tEdge, i);
+      edges[offsets[edge->q->index_]++] = *edge;
+    }
+
+  for (i = n_points; i > 0; i--)
+    offsets[i] = offsets[i - 1];
+  offsets[0] = 0;
+}
+
+guint
+p2t_sweepcontext_get_point_edges (P2tSweepContext *THIS, P2tPoint* point, P2tEdge** edges)
+{
+  guint start = THIS->edge_offsets_[point->index_];
+
+  *edges = THIS->edges_ + start;
+  return THIS->edge_offsets_[point->index_ + 1] - start;
+}
+
+#define P2T_ORIENT(a,b,c) p2t_predicates_orient2d ((a)->x, (a)->y, (b)->x, (b)->y, (c)->x, (c)->y)
+
+/* Add the edges of the convex hull of the (sorted) points as constraints.
+ * The corners are found by a monotone chain scan, and the points lying on
+ * the hull between two corners are then put back on the hull polygon, so
+ * that no point lies on a constraint edge. Returns FALSE if the hull is
+ * degenerate (all the points are collinear) */
+static gboolean
+p2t_sweepcontext_init_hull_edges (P2tSweepContext *THIS)
+{
+  P2tPointPtrArray points = THIS->points_;
+  P2tPoint **right, **left, **hull;
+  guint n = points->len, n_right = 0, n_left = 0, ir = 0, il = 0, m_right = 0, m_left = 0, i;
+
+  /* Room for both chains (each has n points at most), and for the hull */
+  g_ptr_array_set_size (THIS->hull_, 3 * n);
+  right = (P2tPoint**) THIS->hull_->pdata;
+  left = right + n;
+  hull = left + n;
+
+  /* The corners on the right of the hull, from the lowest point up */
+  for (i = 0; i < n; i++)
+    {
+      P2tPoint *p = point_index (points, i);
+      while (n_right >= 2 && P2T_ORIENT (right[n_right - 2], right[n_right - 1], p) <= 0)
+        n_right--;
+      right[n_right++] = p;
+    }
+
+  /* The corners on the left, from the highest point down */
+  for (i = n; i > 0; i--)
+    {
+      P2tPoint *p = point_index (points, i - 1);
+      while (n_left >= 2 && P2T_ORIENT (left[n_left - 2], left[n_left - 1], p) <= 0)
+        n_left--;
+      left[n_left++] = p;
+    }
+
+  if (n_right + n_left < 5)
+    return FALSE;
+
+  /* Walk up both chains together with the sorted points. A point which is
+   * not a corner lies between the current corners of each chain in the
+   * sweep order, so it is on the hull if it is collinear with either pair.
+   * The right side is stored upwards from the start of the hull, and the
+   * left side downwards from its end, which gives the polygon order */
+  hull[m_right++] = point_index (points, 0);
+  for (i = 1; i < n; i++)
+    {
+      P2tPoint *p = point_index (points, i);
+      P2tPoint *l0 = left[n_left - 1 - il], *l1 = left[n_left - 2 - il];
+
+      if (p == right[ir + 1])
+        {
+          ir++;
+          hull[m_right++] = p;
+          if (p == l1)
+            il++;
+        }
+      else if (p == l1)
+        {
+          il++;
+          hull[n - 1 - m_left++] = p;
+        }
+      else if (P2T_ORIENT (right[ir], right[ir + 1], p) == 0)
+        hull[m_right++] = p;
+      else if (P2T_ORIENT (l0, l1, p) == 0)
+        hull[n - 1 - m_left++] = p;
+    }
+
+  memmove (THIS->hull_->pdata, hull, m_right * sizeof (P2tPoint*));
+  memmove (THIS->hull_->pdata + m_right, hull + n - m_left, m_left * sizeof (P2tPoint*));
+  g_ptr_array_set_size (THIS->hull_, m_right + m_left);
+
+  p2t_sweepcontext_init_edges (THIS, THIS->hull_);
+  return TRUE;
+}
+
+/* Remember the input order of the points, and find on which side of each
+ * ring the domain lies. The lowest point of a ring is a convex corner, so
+ * the turn of the ring there gives its orientation */
+static void
+p2t_sweepcontext_init_rings (P2tSweepContext *THIS)
+{
+  guint i, j;
+
+  g_ptr_array_set_size (THIS->input_, THIS->points_->len);
+  memcpy (THIS->input_->pdata, THIS->points_->pdata, THIS->points_->len * sizeof (gpointer));
+
+  for (i = 0; i < THIS->rings_->len; i++)
+    {
+      P2tSweepContextRing *ring = &g_array_index (THIS->rings_, P2tSweepContextRing, i);
+      P2tPoint **points = (P2tPoint**) THIS->input_->pdata + ring->start;
+      guint lowest = 0;
+      gboolean ccw;
+
+      if (ring->length < 3)
+        continue;
+
+      for (j = 1; j < ring->length; j++)
+        if (p2t_point_cmp (&points[j], &points[lowest]) < 0)
+          lowest = j;
+
+      ccw = P2T_ORIENT (points[(lowest + ring->length - 1) % ring->length],
+                        points[lowest],
+                        points[(lowest + 1) % ring->length]) > 0;
+
+      /* The domain is inside the outline and outside of the holes */
+      ring->interior_left = (i == 0) ? ccw : ! ccw;
+    }
+}
+
+gboolean
 p2t_sweepcontext_init_triangulation (P2tSweepContext *THIS)
 {
   guint i;
-  double xmax = point_index (THIS->points_, 0)->x, xmin = point_index (THIS->points_, 0)->x;
-  double ymax = point_index (THIS->points_, 0)->y, ymin = point_index (THIS->points_, 0)->y;
+  double xmax, xmin, ymax, ymin;
   double dx, dy;
 
+  /* A point cloud needs at least a triangle */
+  if (THIS->point_cloud_ && THIS->points_->len < 3)
+    return FALSE;
+
+  xmax = xmin = point_index (THIS->points_, 0)->x;
+  ymax = ymin = point_index (THIS->points_, 0)->y;
+
   /* Calculate bounds. */
   for (i = 0; i < THIS->points_->len; i++)
     {
@@ -188,11 +466,97 @@ p2t_sweepcontext_init_triangulation (P2tSweepContext *THIS)
 
   dx = kAlpha * (xmax - xmin);
   dy = kAlpha * (ymax - ymin);
-  THIS->head_ = p2t_point_new_dd (xmax + dx, ymin - dy);
-  THIS->tail_ = p2t_point_new_dd (xmin - dx, ymin - dy);
+  /* After a reset, the points of the previous triangulation are reused */
+  if (THIS->head_ == NULL)
+    THIS->head_ = p2t_point_new ();
+  if (THIS->tail_ == NULL)
+    THIS->tail_ = p2t_point_new ();
+  p2t_point_init_dd (THIS->head_, xmax + dx, ymin - dy);
+  p2t_point_init_dd (THIS->tail_, xmin - dx, ymin - dy);
+
+  if (! THIS->point_cloud_)
+    p2t_sweepcontext_init_rings (THIS);
 
   /* Sort points along y-axis */
-  g_ptr_array_sort (THIS->points_, p2t_point_cmp);
+  if (THIS->presorted_)
+    {
+#ifndef G_DISABLE_ASSERT
+      for (i = 1; i < THIS->points_->len; i++)
+        g_assert (p2t_point_cmp (&THIS->points_->pdata[i - 1], &THIS->points_->pdata[i]) <= 0);
+#endif
+    }
+  else
+    p2t_point_array_sort (THIS->points_, THIS->sort_threads_, THIS->sort_scratch_);
+
+  if (THIS->point_cloud_ && ! p2t_sweepcontext_init_hull_edges (THIS))
+    return FALSE;
+
+  p2t_sweepcontext_init_point_edges (THIS);
+  return TRUE;
+}
+
+gboolean
+p2t_sweepcontext_is_point_cloud (P2tSweepContext *THIS)
+{
+  return THIS->point_cloud_;
+}
+
+void
+p2t_sweepcontext_set_presorted (P2tSweepContext *THIS, gboolean presorted)
+{
+  THIS->presorted_ = presorted;
+}
+
+void
+p2t_sweepcontext_set_sort_threads (P2tSweepContext *THIS, guint n_threads)
+{
+  THIS->sort_threads_ = n_threads;
+}
+
+void
+p2t_sweepcontext_set_sweep_threads (P2tSweepContext *THIS, guint n_threads)
+{
+  THIS->sweep_threads_ = n_threads;
+}
+
+guint
+p2t_sweepcontext_get_sweep_threads (P2tSweepContext *THIS)
+{
+  return THIS->sweep_threads_;
+}
+
+void
+p2t_sweepcontext_set_front_index (P2tSweepContext *THIS, gboolean front_index)
+{
+  THIS->front_index_ = front_index;
+}
+
+gboolean
+p2t_sweepcontext_get_front_index (P2tSweepContext *THIS)
+{
+  return THIS->front_index_;
+}
+
+void
+p2t_sweepcontext_set_monotone_mode (P2tSweepContext *THIS, P2tMonotoneMode mode)
+{
+  THIS->monotone_mode_ = mode;
+}
+
+P2tMonotoneMode
+p2t_sweepcontext_get_monotone_mode (P2tSweepContext *THIS)
+{
+  return THIS->monotone_mode_;
+}
+
+P2tPointPtrArray
+p2t_sweepcontext_get_lone_polyline (P2tSweepContext *THIS)
+{
+  /* The polyline comes first among the points, followed by the holes and
+   * the Steiner points */
+  if (THIS->point_cloud_ || THIS->points_->len != THIS->polyline_length_)
+    return NULL;
+  return THIS->points_;
 }
 
 void
@@ -200,14 +564,41 @@ p2t_sweepcontext_init_edges (P2tSweepContext *THIS, P2tPointPtrArray polyline)
 {
   int i;
   int num_points = polyline->len;
-  g_ptr_array_set_size (THIS->edge_list, THIS->edge_list->len + num_points); /* C-OPTIMIZATION */
   for (i = 0; i < num_points; i++)
     {
       int j = i < num_points - 1 ? i + 1 : 0;
-      g_ptr_array_add (THIS->edge_list, p2t_edge_new (point_index (polyline, i), point_index (polyline, j)));
+      P2tEdge edge;
+      p2t_edge_init (&edge, point_index (polyline, i), point_index (polyline, j));
+      g_array_append_val (THIS->edge_list, edge);
     }
 }
 
+void
+p2t_sweepcontext_add_edge (P2tSweepContext *THIS, P2tPoint* p, P2tPoint* q)
+{
+  P2tEdge edge;
+  p2t_edge_init (&edge, p, q);
+  g_array_append_val (THIS->edge_list, edge);
+}
+
+GArray*
+p2t_sweepcontext_get_edges (P2tSweepContext *THIS)
+{
+  return THIS->edge_list;
+}
+
+P2tSweepContext*
+p2t_sweepcontext_get_part (P2tSweepContext *THIS, guint index)
+{
+  while (THIS->parts_->len <= index)
+    {
+      GPtrArray *none = g_ptr_array_new ();
+      g_ptr_array_add (THIS->parts_, p2t_sweepcontext_new_point_cloud (none));
+      g_ptr_array_free (none, TRUE);
+    }
+  return (P2tSweepContext*) g_ptr_array_index (THIS->parts_, index);
+}
+
 P2tPoint*
 p2t_sweepcontext_get_point (P2tSweepContext *THIS, const int index)
 {
@@ -217,28 +608,35 @@ p2t_sweepcontext_get_point (P2tSweepContext *THIS, const int index)
 void
 p2t_sweepcontext_add_to_map (P2tSweepContext *THIS, P2tTriangle* triangle)
 {
-  THIS->map_ = g_list_append (THIS->map_, triangle);
+  triangle->map_index_ = THIS->map_->len;
+  g_ptr_array_add (THIS->map_, triangle);
 }
 
 P2tNode*
 p2t_sweepcontext_locate_node (P2tSweepContext *THIS, P2tPoint* point)
 {
-  /* TODO implement search tree */
   return p2t_advancingfront_locate_node (THIS->front_, point->x);
 }
 
 void
-p2t_sweepcontext_create_advancingfront (P2tSweepContext *THIS, P2tNodePtrArray nodes)
+p2t_sweepcontext_create_advancingfront (P2tSweepContext *THIS)
 {
   /* Initial triangle */
-  P2tTriangle* triangle = p2t_triangle_new (point_index (THIS->points_, 0), THIS->tail_, THIS->head_);
+  P2tTriangle* triangle = p2t_sweepcontext_new_triangle (THIS, point_index (THIS->points_, 0), THIS->tail_, THIS->head_);
 
-  THIS->map_ = g_list_append (THIS->map_, triangle);
+  p2t_sweepcontext_add_to_map (THIS, triangle);
 
-  THIS->af_head_ = p2t_node_new_pt_tr (p2t_triangle_get_point (triangle, 1), triangle);
-  THIS->af_middle_ = p2t_node_new_pt_tr (p2t_triangle_get_point (triangle, 0), triangle);
-  THIS->af_tail_ = p2t_node_new_pt (p2t_triangle_get_point (triangle, 2));
-  THIS->front_ = p2t_advancingfront_new (THIS->af_head_, THIS->af_tail_);
+  THIS->af_head_ = p2t_sweepcontext_new_node (THIS, p2t_triangle_get_point (triangle, 1), triangle);
+  THIS->af_middle_ = p2t_sweepcontext_new_node (THIS, p2t_triangle_get_point (triangle, 0), triangle);
+  THIS->af_tail_ = p2t_sweepcontext_new_node (THIS, p2t_triangle_get_point (triangle, 2), NULL);
+  if (THIS->front_ != NULL)
+    {
+      /* Reuse the front of the previous triangulation */
+      p2t_advancingfront_destroy (THIS->front_);
+      p2t_advancingfront_init (THIS->front_, THIS->af_head_, THIS->af_tail_);
+    }
+  else
+    THIS->front_ = p2t_advancingfront_new (THIS->af_head_, THIS->af_tail_);
 
   /* TODO: More intuitiv if head is middles next and not previous?
    *       so swap head and tail */
@@ -246,12 +644,31 @@ p2t_sweepcontext_create_advancingfront (P2tSweepContext *THIS, P2tNodePtrArray n
   THIS->af_middle_->next = THIS->af_tail_;
   THIS->af_middle_->prev = THIS->af_head_;
   THIS->af_tail_->prev = THIS->af_middle_;
+
+  if (THIS->front_index_)
+    p2t_advancingfront_build_index (THIS->front_);
 }
 
 void
 p2t_sweepcontext_remove_node (P2tSweepContext *THIS, P2tNode* node)
 {
-  g_free (node);
+  /* Nodes are allocated from the arena, and released with it */
+}
+
+P2tTriangle*
+p2t_sweepcontext_new_triangle (P2tSweepContext *THIS, P2tPoint* a, P2tPoint* b, P2tPoint* c)
+{
+  P2tTriangle *triangle = p2t_arena_new (&THIS->arena_, P2tTriangle);
+  p2t_triangle_init (triangle, a, b, c);
+  return triangle;
+}
+
+P2tNode*
+p2t_sweepcontext_new_node (P2tSweepContext *THIS, P2tPoint* p, P2tTriangle* t)
+{
+  P2tNode *node = p2t_arena_new (&THIS->arena_, P2tNode);
+  p2t_node_init_pt_tr (node, p, t);
+  return node;
 }
 
 void
@@ -272,32 +689,112 @@ p2t_sweepcontext_map_triangle_to_nodes (P2tSweepContext *THIS, P2tTriangle* t)
 void
 p2t_sweepcontext_remove_from_map (P2tSweepContext *THIS, P2tTriangle* triangle)
 {
-  THIS->map_ = g_list_remove (THIS->map_, triangle);
+  guint index = triangle->map_index_;
+
+  g_assert (index < THIS->map_->len && triangle_index (THIS->map_, index) == triangle);
+
+  /* Move the last triangle into the freed slot instead of shifting */
+  g_ptr_array_remove_index_fast (THIS->map_, index);
+  if (index < THIS->map_->len)
+    triangle_index (THIS->map_, index)->map_index_ = index;
+
+  triangle->map_index_ = G_MAXUINT;
 }
 
 void
-p2t_sweepcontext_mesh_clean (P2tSweepContext *THIS, P2tTriangle* triangle)
+p2t_sweepcontext_add_to_result (P2tSweepContext *THIS, P2tTriangle* triangle)
 {
-  GQueue triangles = G_QUEUE_INIT;
-  int i;
+  triangle->result_index_ = THIS->triangles_->len;
+  g_ptr_array_add (THIS->triangles_, triangle);
+}
 
-  g_queue_push_tail (&triangles, triangle);
+void
+p2t_sweepcontext_remove_from_result (P2tSweepContext *THIS, P2tTriangle* triangle)
+{
+  guint index = triangle->result_index_;
+
+  g_assert (index < THIS->triangles_->len && triangle_index (THIS->triangles_, index) == triangle);
+
+  g_ptr_array_remove_index_fast (THIS->triangles_, index);
+  if (index < THIS->triangles_->len)
+    triangle_index (THIS->triangles_, index)->result_index_ = index;
+
+  triangle->result_index_ = G_MAXUINT;
+}
+
+/* Find the ring of the point with the given input index, or NULL if it is
+ * not on any ring (a Steiner point) */
+static P2tSweepContextRing*
+p2t_sweepcontext_find_ring (P2tSweepContext *THIS, guint index)
+{
+  guint lo = 0, hi = THIS->rings_->len;
+  P2tSweepContextRing *ring;
 
-  while (! g_queue_is_empty (&triangles))
+  /* Find the last ring which starts at or before the index */
+  while (lo < hi)
     {
-      P2tTriangle* t = (P2tTriangle*) g_queue_pop_tail (&triangles);
+      guint mid = (lo + hi) / 2;
+      if (g_array_index (THIS->rings_, P2tSweepContextRing, mid).start <= index)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  if (lo == 0)
+    return NULL;
+
+  ring = &g_array_index (THIS->rings_, P2tSweepContextRing, lo - 1);
+  return (index - ring->start < ring->length) ? ring : NULL;
+}
+
+gboolean
+p2t_sweepcontext_is_interior_triangle (P2tSweepContext *THIS, P2tTriangle* triangle)
+{
+  int i;
 
-      if (t != NULL && !p2t_triangle_is_interior (t))
+  /* The head and the tail points are outside of the outline */
+  if (p2t_triangle_contains_pt (triangle, THIS->head_) || p2t_triangle_contains_pt (triangle, THIS->tail_))
+    return FALSE;
+
+  for (i = 0; i < 3; i++)
+    {
+      P2tPoint *v = p2t_triangle_get_point (triangle, i);
+      P2tSweepContextRing *ring = p2t_sweepcontext_find_ring (THIS, v->index_);
+      P2tPoint **points, *u, *a, *b;
+      guint k;
+
+      if (ring == NULL)
+        continue;
+
+      points = (P2tPoint**) THIS->input_->pdata + ring->start;
+      k = v->index_ - ring->start;
+      u = p2t_triangle_get_point (triangle, (i + 1) % 3);
+
+      /* Around v, the domain is the wedge from b counter-clockwise to a.
+       * No constraint edge crosses the triangle, so going counter-clockwise
+       * from u it lies either all inside or all outside of that wedge */
+      a = points[(k + ring->length - 1) % ring->length];
+      b = points[(k + 1) % ring->length];
+      if (! ring->interior_left)
         {
-          p2t_triangle_is_interior_b (t, TRUE);
-          g_ptr_array_add (THIS->triangles_, t);
-          for (i = 0; i < 3; i++)
-            {
-              if (! t->constrained_edge[i])
-                g_queue_push_tail (&triangles, p2t_triangle_get_neighbor (t, i));
-            }
+          P2tPoint *tmp = a;
+          a = b;
+          b = tmp;
         }
+
+      if (u == b)
+        return TRUE;
+      if (u == a)
+        return FALSE;
+
+      if (P2T_ORIENT (v, b, a) > 0)
+        return P2T_ORIENT (v, b, u) > 0 && P2T_ORIENT (v, u, a) > 0;
+      else
+        return ! (P2T_ORIENT (v, a, u) > 0 && P2T_ORIENT (v, u, b) > 0);
     }
+
+  /* All the points are Steiner points, which lie inside the domain */
+  return TRUE;
 }
 
 P2tAdvancingFront*
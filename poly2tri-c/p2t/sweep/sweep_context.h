@@ -37,13 +37,18 @@
 #define __P2TC_P2T_SWEEP_CONTEXT_H__
 
 #include "../common/poly2tri-private.h"
+#include "../common/arena.h"
 #include "../common/shapes.h"
 #include "advancing_front.h"
+#include "monotone.h"
 
 /* Inital triangle factor, seed triangle will extend 30% of
  * PointSet width to both left and right. */
 #define kAlpha 0.3
 
+/* The size of each block in the arena of the sweep context */
+#define P2T_SWEEPCONTEXT_ARENA_BLOCK_SIZE (64 * 1024)
+
 struct P2tSweepContextBasin_
 {
   P2tNode* left_node;
@@ -64,16 +69,62 @@ struct P2tSweepContextEdgeEvent_
 
 void p2t_sweepcontext_edgeevent_init (P2tSweepContextEdgeEvent* THIS);
 
+/* A closed polyline of the input - the outline or a hole. Its points have
+ * consecutive input indices */
+struct P2tSweepContextRing_
+{
+  guint start;
+  guint length;
+  /* Is the inside of the triangulated domain on the left of the edges of
+   * the ring, when they are walked in the input order? */
+  gboolean interior_left;
+};
+
 struct SweepContext_
 {
-  P2tEdgePtrArray edge_list;
+  /** The memory of all the triangles and advancing front nodes created by
+   * this context. It is released when the context is reset or destroyed */
+  P2tArena arena_;
+
+  /** The constraint edges (#P2tEdge), in the order they were added */
+  GArray* edge_list;
+  /** The constraint edges grouped by their upper point, built by
+   * init_triangulation. The edges of the point with input index i are
+   * edges_[edge_offsets_[i]] up to (excluding) edges_[edge_offsets_[i + 1]] */
+  P2tEdge* edges_;
+  guint* edge_offsets_;
+  /** The allocated sizes of edges_ and edge_offsets_, which are kept (and
+   * only grown) when the context is reset */
+  guint edges_size_;
+  guint edge_offsets_size_;
 
   P2tSweepContextBasin basin;
   P2tSweepContextEdgeEvent edge_event;
 
+  /** The interior triangles, the result of the triangulation. Each of
+   * them remembers its slot here (result_index_), like in map_ */
   P2tTrianglePtrArray triangles_;
-  P2tTrianglePtrList map_;
+  /** All the triangles created by the sweep. Each triangle remembers its
+   * slot in this array (map_index_), so both adding and removing are O(1) */
+  P2tTrianglePtrArray map_;
   P2tPointPtrArray points_;
+  /** Are the points already added in sweep order (no sorting needed)? */
+  gboolean presorted_;
+  /** The maximal amount of threads for sorting the points (0 for one
+   * per processor) */
+  guint sort_threads_;
+  /** The maximal amount of threads (and slabs) for sweeping the points,
+   * with the same meaning */
+  guint sweep_threads_;
+  /** Should the advancing front keep an ordered index of its nodes? */
+  gboolean front_index_;
+  /** Are the points a cloud, to be triangulated up to their convex hull
+   * instead of inside a polyline? */
+  gboolean point_cloud_;
+  /** How a polygon without holes and Steiner points is triangulated */
+  P2tMonotoneMode monotone_mode_;
+  /** The amount of points in the polyline */
+  guint polyline_length_;
 
   /** Advancing front */
   P2tAdvancingFront* front_;
@@ -83,12 +134,40 @@ struct SweepContext_
   P2tPoint* tail_;
 
   P2tNode *af_head_, *af_middle_, *af_tail_;
+
+  /** Temporary storage for sorting the points */
+  GByteArray* sort_scratch_;
+  /** The outline and the holes (#P2tSweepContextRing), in the order they
+   * were added */
+  GArray* rings_;
+  /** The points in the input order, kept by init_triangulation when
+   * points_ is sorted */
+  P2tPointPtrArray input_;
+  /** The convex hull of a point cloud */
+  P2tPointPtrArray hull_;
+  /** The contexts of the pieces of a parallel sweep, which own the
+   * triangles that they made. They are kept (and reused) until the next
+   * parallel sweep */
+  GPtrArray* parts_;
 };
 
 /** Constructor */
 void p2t_sweepcontext_init (P2tSweepContext* THIS, P2tPointPtrArray polyline);
 P2tSweepContext* p2t_sweepcontext_new (P2tPointPtrArray polyline);
 
+/** Constructor for the Delaunay triangulation of a point cloud. There is no
+ * polyline and no holes - the constraints are the edges of the convex hull
+ * of the points, found when the triangulation starts */
+void p2t_sweepcontext_init_point_cloud (P2tSweepContext* THIS, P2tPointPtrArray points);
+P2tSweepContext* p2t_sweepcontext_new_point_cloud (P2tPointPtrArray points);
+
+/** Forget the input and the result of the previous triangulation and start
+ * over with a new polyline, as if the context was just created with it.
+ * All the memory of the context is kept and reused, and the options (sort
+ * threads, sweep threads, presorted input, front index) are kept as well */
+void p2t_sweepcontext_reset (P2tSweepContext* THIS, P2tPointPtrArray polyline);
+void p2t_sweepcontext_reset_point_cloud (P2tSweepContext* THIS, P2tPointPtrArray points);
+
 /** Destructor */
 void p2t_sweepcontext_destroy (P2tSweepContext* THIS);
 void p2t_sweepcontext_delete (P2tSweepContext* THIS);
@@ -107,7 +186,13 @@ P2tNode* p2t_sweepcontext_locate_node (P2tSweepContext *THIS, P2tPoint* point);
 
 void p2t_sweepcontext_remove_node (P2tSweepContext *THIS, P2tNode* node);
 
-void p2t_sweepcontext_create_advancingfront (P2tSweepContext *THIS, P2tNodePtrArray nodes);
+/** Allocate a new triangle from the arena of the context */
+P2tTriangle* p2t_sweepcontext_new_triangle (P2tSweepContext *THIS, P2tPoint* a, P2tPoint* b, P2tPoint* c);
+
+/** Allocate a new advancing front node from the arena of the context */
+P2tNode* p2t_sweepcontext_new_node (P2tSweepContext *THIS, P2tPoint* p, P2tTriangle* t);
+
+void p2t_sweepcontext_create_advancingfront (P2tSweepContext *THIS);
 
 /** Try to map a node to all sides of this triangle that don't have a neighbor */
 void p2t_sweepcontext_map_triangle_to_nodes (P2tSweepContext *THIS, P2tTriangle* t);
@@ -120,18 +205,78 @@ P2tPoint* SweepContext_GetPoints (P2tSweepContext *THIS);
 
 void p2t_sweepcontext_remove_from_map (P2tSweepContext *THIS, P2tTriangle* triangle);
 
+/** Add a triangle to the result, or remove it from the result, in O(1).
+ * Removing moves the last triangle of the result into the freed slot */
+void p2t_sweepcontext_add_to_result (P2tSweepContext *THIS, P2tTriangle* triangle);
+void p2t_sweepcontext_remove_from_result (P2tSweepContext *THIS, P2tTriangle* triangle);
+
 void p2t_sweepcontext_add_hole (P2tSweepContext *THIS, P2tPointPtrArray polyline);
 
 void p2t_sweepcontext_add_point (P2tSweepContext *THIS, P2tPoint* point);
 
 P2tAdvancingFront* p2t_sweepcontext_front (P2tSweepContext *THIS);
 
-void p2t_sweepcontext_mesh_clean (P2tSweepContext *THIS, P2tTriangle* triangle);
+/** Is the triangle inside the triangulated domain? Valid after the sweep of
+ * a polygon (not of a point cloud). Each triangle is classified on its own,
+ * without visiting its neighbors */
+gboolean p2t_sweepcontext_is_interior_triangle (P2tSweepContext *THIS, P2tTriangle* triangle);
 
 P2tTrianglePtrArray p2t_sweepcontext_get_triangles (P2tSweepContext *THIS);
-P2tTrianglePtrList p2t_sweepcontext_get_map (P2tSweepContext *THIS);
-
-void p2t_sweepcontext_init_triangulation (P2tSweepContext *THIS);
+P2tTrianglePtrArray p2t_sweepcontext_get_map (P2tSweepContext *THIS);
+
+/** Tell the context that the points (the polyline, then the holes and the
+ * Steiner points, in the order they were added) are already sorted by y and
+ * then by x, so that sorting them can be skipped */
+void p2t_sweepcontext_set_presorted (P2tSweepContext *THIS, gboolean presorted);
+
+/** Set the maximal amount of threads for sorting the points. The default is
+ * 1, and 0 means one thread per processor */
+void p2t_sweepcontext_set_sort_threads (P2tSweepContext *THIS, guint n_threads);
+
+/** Set the maximal amount of threads for sweeping large inputs in slabs
+ * (see #P2tSlabs). The default is 1, which sweeps all the points at once,
+ * and 0 means one thread per processor */
+void p2t_sweepcontext_set_sweep_threads (P2tSweepContext *THIS, guint n_threads);
+guint p2t_sweepcontext_get_sweep_threads (P2tSweepContext *THIS);
+
+/** Choose whether the advancing front should be searched through an
+ * ordered index (logarithmic time per point), or by walking it from the
+ * last visited node (the default, fast when consecutive points are close) */
+void p2t_sweepcontext_set_front_index (P2tSweepContext *THIS, gboolean front_index);
+gboolean p2t_sweepcontext_get_front_index (P2tSweepContext *THIS);
+
+/** Choose how a polygon without holes and Steiner points is triangulated.
+ * The default is P2T_MONOTONE_AUTO */
+void p2t_sweepcontext_set_monotone_mode (P2tSweepContext *THIS, P2tMonotoneMode mode);
+P2tMonotoneMode p2t_sweepcontext_get_monotone_mode (P2tSweepContext *THIS);
+
+/** Get the polyline if it is the whole input (there are no holes and no
+ * Steiner points), or NULL otherwise. Valid before init_triangulation */
+P2tPointPtrArray p2t_sweepcontext_get_lone_polyline (P2tSweepContext *THIS);
+
+/** Prepare the points and the edges for the sweep. Returns FALSE if there
+ * is nothing to triangulate (a point cloud without a proper hull) */
+gboolean p2t_sweepcontext_init_triangulation (P2tSweepContext *THIS);
+
+gboolean p2t_sweepcontext_is_point_cloud (P2tSweepContext *THIS);
 void p2t_sweepcontext_init_edges (P2tSweepContext *THIS, P2tPointPtrArray polyline);
 
+/** Add a constraint edge between two of the input points which is not on
+ * any outline, for example inside a point cloud. Constraint edges may not
+ * cross each other, and no point may lie inside them */
+void p2t_sweepcontext_add_edge (P2tSweepContext *THIS, P2tPoint* p, P2tPoint* q);
+
+/** Get the constraint edges (#P2tEdge), in the order they were added */
+GArray* p2t_sweepcontext_get_edges (P2tSweepContext *THIS);
+
+/** Get the index'th of the contexts which triangulate the pieces of a
+ * parallel sweep, creating it if needed. Its triangles live until it is
+ * reset, or until this context is destroyed */
+P2tSweepContext* p2t_sweepcontext_get_part (P2tSweepContext *THIS, guint index);
+
+/** Get the constraint edges for which the point is the upper ending point.
+ * Valid only after init_triangulation. Returns the amount of edges, and
+ * stores a pointer to the first in @edges */
+guint p2t_sweepcontext_get_point_edges (P2tSweepContext *THIS, P2tPoint* point, P2tEdge** edges);
+
 #endif
@@ -256,7 +256,7 @@ p2tr_dt_refine (P2trDelaunayTerminator   *self,
                 gint                      max_steps,
                 P2trRefineProgressNotify  on_progress)
 {
-  P2trHashSetIter hs_iter;
+  P2trDenseSetIter hs_iter;
   P2trEdge *s;
   P2trTriangle *t;
   P2trVTriangle *vt;
@@ -267,16 +267,16 @@ p2tr_dt_refine (P2trDelaunayTerminator   *self,
   if (steps++ >= max_steps)
     return;
 
-  p2tr_hash_set_iter_init (&hs_iter, self->cdt->mesh->edges);
-    while (p2tr_hash_set_iter_next (&hs_iter, (gpointer*)&s))
+  p2tr_dense_set_iter_init (&hs_iter, self->cdt->mesh->edges);
+    while (p2tr_dense_set_iter_next (&hs_iter, (gpointer*)&s))
     if (s->constrained && p2tr_cdt_is_encroached (s))
       p2tr_dt_enqueue_segment (self, s);
 
   SplitEncroachedSubsegments (self, 0, p2tr_refiner_false_too_big);
   P2TR_CDT_VALIDATE_CDT (self->cdt);
 
-  p2tr_hash_set_iter_init (&hs_iter, self->cdt->mesh->triangles);
-  while (p2tr_hash_set_iter_next (&hs_iter, (gpointer*)&t))
+  p2tr_dense_set_iter_init (&hs_iter, self->cdt->mesh->triangles);
+  while (p2tr_dense_set_iter_next (&hs_iter, (gpointer*)&t))
     if (p2tr_triangle_smallest_non_constrained_angle (t) < self->theta)
       p2tr_dt_enqueue_tri (self, t);
 
@@ -411,7 +411,7 @@ SplitEncroachedSubsegments (P2trDelaunayTerminator *self, gdouble theta, P2trTri
   while (! p2tr_dt_segment_queue_is_empty (self))
   {
     P2trEdge *s = p2tr_dt_dequeue_segment (self);
-    if (p2tr_hash_set_contains (self->cdt->mesh->edges, s))
+    if (p2tr_dense_set_contains (self->cdt->mesh->edges, s->handle, s))
       {
         P2trVector2 v;
         P2trPoint *Pv;
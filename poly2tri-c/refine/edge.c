@@ -37,6 +37,7 @@
 #include "edge.h"
 #include "triangle.h"
 #include "mesh.h"
+#include "mesh-pool.h"
 
 static void
 p2tr_edge_init (P2trEdge  *self,
@@ -53,6 +54,7 @@ p2tr_edge_init (P2trEdge  *self,
   self->mirror      = mirror;
   self->refcount    = 0;
   self->tri         = NULL;
+  self->handle      = P2TR_DENSE_SET_NO_HANDLE;
 }
 
 P2trEdge*
@@ -60,11 +62,33 @@ p2tr_edge_new (P2trPoint *start,
                P2trPoint *end,
                gboolean   constrained)
 {
-  P2trEdge *self   = g_slice_new (P2trEdge);
-  P2trEdge *mirror = g_slice_new (P2trEdge);
+  return p2tr_edge_new_from_pool (NULL, start, end, constrained);
+}
+
+P2trEdge*
+p2tr_edge_new_from_pool (P2trMeshPool *pool,
+                         P2trPoint    *start,
+                         P2trPoint    *end,
+                         gboolean      constrained)
+{
+  P2trEdge *self, *mirror;
+
+  if (pool != NULL)
+    {
+      /* Keep both halves next to each other, since walking the mesh
+       * keeps moving from edges to their mirrors */
+      self   = (P2trEdge*) p2tr_mesh_pool_alloc (pool);
+      mirror = self + 1;
+    }
+  else
+    {
+      self   = g_slice_new (P2trEdge);
+      mirror = g_slice_new (P2trEdge);
+    }
 
   p2tr_edge_init (self, start, end, constrained, mirror);
   p2tr_edge_init (mirror, end, start, constrained, self);
+  self->pool = mirror->pool = pool;
 
   p2tr_point_ref (start);
   p2tr_point_ref (end);
@@ -151,8 +175,13 @@ void
 p2tr_edge_free (P2trEdge *self)
 {
   g_assert (p2tr_edge_is_removed (self));
-  g_slice_free (P2trEdge, self->mirror);
-  g_slice_free (P2trEdge, self);
+  if (self->pool != NULL)
+    p2tr_mesh_pool_free (self->pool, MIN (self, self->mirror));
+  else
+    {
+      g_slice_free (P2trEdge, self->mirror);
+      g_slice_free (P2trEdge, self);
+    }
 }
 
 void
@@ -51,6 +51,9 @@ struct P2trEdge_
   
   /** Is this a constrained edge? */
   gboolean      constrained;
+
+  /** The handle of this edge in the edges of its mesh */
+  guint         handle;
   
   /** The triangle where this edge goes clockwise along its outline */
   P2trTriangle *tri;
@@ -71,6 +74,12 @@ struct P2trEdge_
 
   /** A count of references to the edge */
   guint         refcount;
+
+  /**
+   * The pool this edge was allocated from, or NULL. An edge and its
+   * mirror are allocated together, as one chunk of the pool
+   */
+  P2trMeshPool *pool;
 };
 
 #define P2TR_EDGE_START(E) ((E)->mirror->end)
@@ -79,6 +88,14 @@ P2trEdge*   p2tr_edge_new                  (P2trPoint *start,
                                             P2trPoint *end,
                                             gboolean   constrained);
 
+/** Like \ref p2tr_edge_new, but allocate the edge and its mirror from
+ * the given pool (or from the slice allocator, if it is NULL). The pool
+ * must have chunks of two edges */
+P2trEdge*   p2tr_edge_new_from_pool        (P2trMeshPool *pool,
+                                            P2trPoint    *start,
+                                            P2trPoint    *end,
+                                            gboolean      constrained);
+
 P2trEdge*   p2tr_edge_ref                  (P2trEdge *self);
 
 void        p2tr_edge_unref                (P2trEdge *self);
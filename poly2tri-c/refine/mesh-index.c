@@ -0,0 +1,211 @@
+/*
+ * This file is a part of Poly2Tri-C
+ * (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <math.h>
+#include <glib.h>
+#include "rutils.h"
+
+#include "mesh.h"
+#include "mesh-index.h"
+#include "point.h"
+#include "edge.h"
+#include "triangle.h"
+
+/* The average amount of triangles per cell when the grid is built */
+#define P2TR_MESH_INDEX_TRIANGLES_PER_CELL 2
+
+/* The index should be built again once the amount of triangles grows
+ * by this factor */
+#define P2TR_MESH_INDEX_MAX_GROWTH 4
+
+/* Map a coordinate to a column or a row of the grid, putting everything
+ * outside of the grid (and NaN) in the cells on its border */
+static guint
+p2tr_mesh_index_cell_of (gdouble coord,
+                         gdouble min,
+                         gdouble inv_cell_size,
+                         guint   count)
+{
+  gdouble c = (coord - min) * inv_cell_size;
+
+  if (! (c >= 0))
+    return 0;
+  else if (c >= count - 1)
+    return count - 1;
+  else
+    return (guint) c;
+}
+
+static void
+p2tr_mesh_index_get_range (P2trMeshIndex *self,
+                           P2trTriangle  *tri,
+                           guint         *x0,
+                           guint         *y0,
+                           guint         *x1,
+                           guint         *y1)
+{
+  const P2trVector2 *A = &P2TR_TRIANGLE_GET_POINT (tri, 0)->c;
+  const P2trVector2 *B = &P2TR_TRIANGLE_GET_POINT (tri, 1)->c;
+  const P2trVector2 *C = &P2TR_TRIANGLE_GET_POINT (tri, 2)->c;
+
+  *x0 = p2tr_mesh_index_cell_of (MIN (A->x, MIN (B->x, C->x)), self->min_x, self->inv_cell_size, self->width);
+  *x1 = p2tr_mesh_index_cell_of (MAX (A->x, MAX (B->x, C->x)), self->min_x, self->inv_cell_size, self->width);
+  *y0 = p2tr_mesh_index_cell_of (MIN (A->y, MIN (B->y, C->y)), self->min_y, self->inv_cell_size, self->height);
+  *y1 = p2tr_mesh_index_cell_of (MAX (A->y, MAX (B->y, C->y)), self->min_y, self->inv_cell_size, self->height);
+}
+
+P2trMeshIndex*
+p2tr_mesh_index_new (P2trMesh *mesh)
+{
+  P2trMeshIndex *self = g_slice_new (P2trMeshIndex);
+  guint n = p2tr_dense_set_size (mesh->triangles);
+  gdouble min_x, min_y, max_x, max_y, w, h, cells, cell_size = 0;
+  P2trDenseSetIter iter;
+  P2trTriangle *tri;
+
+  self->min_x = self->min_y = 0;
+  self->inv_cell_size = 0;
+  self->width = self->height = 1;
+  self->size = 0;
+
+  p2tr_mesh_get_bounds (mesh, &min_x, &min_y, &max_x, &max_y);
+  w = max_x - min_x;
+  h = max_y - min_y;
+  cells = MAX (n / P2TR_MESH_INDEX_TRIANGLES_PER_CELL, 1);
+
+  /* An empty mesh has inverted bounds, and a degenerate one may have
+   * no area at all */
+  if (n > 0 && w >= 0 && h >= 0)
+    cell_size = (w > 0 && h > 0) ? sqrt (w * h / cells) : MAX (w, h) / cells;
+
+  if (cell_size > 0)
+    {
+      self->min_x = min_x;
+      self->min_y = min_y;
+      self->inv_cell_size = 1 / cell_size;
+      /* The product of both is at most about 3 times the amount of
+       * cells, even for a very thin mesh */
+      self->width = (guint) MIN (w * self->inv_cell_size + 1, cells);
+      self->height = (guint) MIN (h * self->inv_cell_size + 1, cells);
+    }
+
+  self->cells = g_new0 (GPtrArray*, self->width * self->height);
+
+  p2tr_dense_set_iter_init (&iter, mesh->triangles);
+  while (p2tr_dense_set_iter_next (&iter, (gpointer*)&tri))
+    p2tr_mesh_index_add (self, tri);
+
+  return self;
+}
+
+void
+p2tr_mesh_index_free (P2trMeshIndex *self)
+{
+  guint i;
+
+  for (i = 0; i < self->width * self->height; i++)
+    if (self->cells[i] != NULL)
+      g_ptr_array_free (self->cells[i], TRUE);
+
+  g_free (self->cells);
+  g_slice_free (P2trMeshIndex, self);
+}
+
+void
+p2tr_mesh_index_add (P2trMeshIndex *self,
+                     P2trTriangle  *tri)
+{
+  guint x0, y0, x1, y1, x, y;
+
+  p2tr_mesh_index_get_range (self, tri, &x0, &y0, &x1, &y1);
+
+  for (y = y0; y <= y1; y++)
+    for (x = x0; x <= x1; x++)
+      {
+        GPtrArray **cell = &self->cells[y * self->width + x];
+        if (*cell == NULL)
+          *cell = g_ptr_array_new ();
+        g_ptr_array_add (*cell, tri);
+      }
+
+  ++self->size;
+}
+
+void
+p2tr_mesh_index_remove (P2trMeshIndex *self,
+                        P2trTriangle  *tri)
+{
+  guint x0, y0, x1, y1, x, y;
+
+  p2tr_mesh_index_get_range (self, tri, &x0, &y0, &x1, &y1);
+
+  for (y = y0; y <= y1; y++)
+    for (x = x0; x <= x1; x++)
+      {
+        GPtrArray *cell = self->cells[y * self->width + x];
+        g_assert (cell != NULL);
+        g_ptr_array_remove_fast (cell, tri);
+      }
+
+  --self->size;
+}
+
+gboolean
+p2tr_mesh_index_is_full (P2trMeshIndex *self)
+{
+  return self->size > P2TR_MESH_INDEX_MAX_GROWTH
+      * P2TR_MESH_INDEX_TRIANGLES_PER_CELL * self->width * self->height;
+}
+
+P2trTriangle*
+p2tr_mesh_index_find (P2trMeshIndex     *self,
+                      const P2trVector2 *pt,
+                      gdouble           *u,
+                      gdouble           *v)
+{
+  guint x = p2tr_mesh_index_cell_of (pt->x, self->min_x, self->inv_cell_size, self->width);
+  guint y = p2tr_mesh_index_cell_of (pt->y, self->min_y, self->inv_cell_size, self->height);
+  GPtrArray *cell = self->cells[y * self->width + x];
+  guint i;
+
+  if (cell == NULL)
+    return NULL;
+
+  for (i = 0; i < cell->len; i++)
+    {
+      P2trTriangle *tri = (P2trTriangle*) g_ptr_array_index (cell, i);
+      if (p2tr_triangle_contains_point2 (tri, pt, u, v) != P2TR_INTRIANGLE_OUT)
+        return tri;
+    }
+
+  return NULL;
+}
@@ -0,0 +1,127 @@
+/*
+ * This file is a part of Poly2Tri-C
+ * (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __P2TC_REFINE_MESH_INDEX_H__
+#define __P2TC_REFINE_MESH_INDEX_H__
+
+#include <glib.h>
+#include "vector2.h"
+#include "triangulation.h"
+
+/**
+ * \defgroup P2trMeshIndex P2trMeshIndex - Point Location Index
+ * A uniform grid over the bounding box of a mesh, used for finding the
+ * triangle containing a point without a starting triangle
+ * @{
+ */
+
+/**
+ * A struct for an index of the triangles of a mesh
+ */
+struct P2trMeshIndex_
+{
+  /** The lower corner of the area covered by the grid. Triangles and
+   * points outside of that area belong to the cells on its border */
+  gdouble     min_x, min_y;
+
+  /** The inverse of the size of a (square) cell */
+  gdouble     inv_cell_size;
+
+  /** The amount of columns and rows of the grid */
+  guint       width, height;
+
+  /**
+   * The triangles whose bounding box overlaps each cell, by rows. A cell
+   * which never had any triangle is NULL
+   */
+  GPtrArray **cells;
+
+  /** The amount of triangles in the index */
+  guint       size;
+};
+
+/**
+ * Create an index of all the triangles of a mesh. The grid is sized for
+ * the current triangles, with about one cell for every two triangles
+ * @param mesh The mesh whose triangles should be indexed
+ * @return The newly created index
+ */
+P2trMeshIndex* p2tr_mesh_index_new     (P2trMesh      *mesh);
+
+/**
+ * Free the memory used by an index. The triangles are not affected
+ * @param self The index to free
+ */
+void           p2tr_mesh_index_free    (P2trMeshIndex *self);
+
+/**
+ * Add a triangle to the index
+ * @param self The index to add the triangle to
+ * @param tri The triangle to add
+ */
+void           p2tr_mesh_index_add     (P2trMeshIndex *self,
+                                        P2trTriangle  *tri);
+
+/**
+ * Remove a triangle from the index. The triangle must still have its
+ * points
+ * @param self The index to remove the triangle from
+ * @param tri The triangle to remove
+ */
+void           p2tr_mesh_index_remove  (P2trMeshIndex *self,
+                                        P2trTriangle  *tri);
+
+/**
+ * Check whether the index holds so many triangles (compared to the
+ * amount of its cells) that it should be built again
+ * @param self The index to check
+ * @return TRUE if the index should be built again, FALSE otherwise
+ */
+gboolean       p2tr_mesh_index_is_full (P2trMeshIndex *self);
+
+/**
+ * Find a triangle of the index containing the point at the given
+ * location, and the UV coordinates of the point inside it
+ * @param[in] self The index whose triangles should be checked
+ * @param[in] pt The location of the point to test
+ * @param[out] u The U coordinate of the point inside the triangle
+ * @param[out] v The V coordinate of the point inside the triangle
+ * @return The triangle containing the given point (without adding a
+ *         reference to it), or NULL if no triangle contains it
+ */
+P2trTriangle*  p2tr_mesh_index_find    (P2trMeshIndex     *self,
+                                        const P2trVector2 *pt,
+                                        gdouble           *u,
+                                        gdouble           *v);
+
+/** @} */
+#endif
@@ -0,0 +1,88 @@
+/*
+ * This file is a part of Poly2Tri-C
+ * (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <glib.h>
+#include "mesh-pool.h"
+
+/* The size of each memory block of a pool */
+#define P2TR_MESH_POOL_BLOCK_SIZE (64 * 1024)
+
+P2trMeshPool*
+p2tr_mesh_pool_new (gsize chunk_size)
+{
+  P2trMeshPool *self = g_slice_new (P2trMeshPool);
+
+  g_assert (chunk_size >= sizeof (gpointer));
+
+  p2t_arena_init (&self->arena, P2TR_MESH_POOL_BLOCK_SIZE);
+  self->free_chunks = NULL;
+  self->chunk_size = chunk_size;
+  self->refcount = 1;
+
+  return self;
+}
+
+gpointer
+p2tr_mesh_pool_alloc (P2trMeshPool *self)
+{
+  gpointer chunk = self->free_chunks;
+
+  if (chunk != NULL)
+    self->free_chunks = *(gpointer*) chunk;
+  else
+    chunk = p2t_arena_alloc (&self->arena, self->chunk_size);
+
+  ++self->refcount;
+  return chunk;
+}
+
+void
+p2tr_mesh_pool_free (P2trMeshPool *self,
+                     gpointer      chunk)
+{
+  *(gpointer*) chunk = self->free_chunks;
+  self->free_chunks = chunk;
+
+  p2tr_mesh_pool_unref (self);
+}
+
+void
+p2tr_mesh_pool_unref (P2trMeshPool *self)
+{
+  g_assert (self->refcount > 0);
+  if (--self->refcount == 0)
+    {
+      p2t_arena_destroy (&self->arena);
+      g_slice_free (P2trMeshPool, self);
+    }
+}
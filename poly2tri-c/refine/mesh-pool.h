@@ -0,0 +1,106 @@
+/*
+ * This file is a part of Poly2Tri-C
+ * (c) Barak Itkin <lightningismyname@gmail.com>
+ * http://code.google.com/p/poly2tri-c/
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * * Neither the name of Poly2Tri nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without specific
+ *   prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __P2TC_REFINE_MESH_POOL_H__
+#define __P2TC_REFINE_MESH_POOL_H__
+
+#include <glib.h>
+#include <poly2tri-c/p2t/common/arena.h>
+#include "triangulation.h"
+
+/**
+ * \defgroup P2trMeshPool P2trMeshPool - Memory Pools of Mesh Elements
+ * Each mesh allocates its points, edges and triangles from its own
+ * pools, so that they are packed together in large blocks of memory
+ * instead of being allocated one by one
+ * @{
+ */
+
+/**
+ * A struct for a pool of memory chunks of one size
+ */
+struct P2trMeshPool_
+{
+  /** The memory blocks of all the chunks ever allocated */
+  P2tArena  arena;
+
+  /**
+   * The chunks which were freed, to be allocated again before taking
+   * new ones from the arena. Each of them begins with a pointer to the
+   * next one
+   */
+  gpointer  free_chunks;
+
+  /** The size of each chunk */
+  gsize     chunk_size;
+
+  /**
+   * A reference held by the owner of the pool, plus one reference per
+   * allocated chunk. The memory of the pool is released once all of
+   * them are gone
+   */
+  guint     refcount;
+};
+
+/**
+ * Create a new empty pool, with one reference held by the caller
+ * @param chunk_size The size of the chunks to allocate from the pool
+ * @return The newly created pool
+ */
+P2trMeshPool* p2tr_mesh_pool_new   (gsize chunk_size);
+
+/**
+ * Allocate a chunk from a pool. The chunk holds a reference to the pool
+ * until it is freed
+ * @param self The pool to allocate from
+ * @return The allocated chunk, whose memory is not cleared
+ */
+gpointer      p2tr_mesh_pool_alloc (P2trMeshPool *self);
+
+/**
+ * Return a chunk to the pool it was allocated from
+ * @param self The pool of the chunk
+ * @param chunk The chunk to free
+ */
+void          p2tr_mesh_pool_free  (P2trMeshPool *self,
+                                    gpointer      chunk);
+
+/**
+ * Release the reference of the owner of a pool. The memory of all the
+ * chunks is released together, once the last chunk is freed
+ * @param self The pool whose reference should be released
+ */
+void          p2tr_mesh_pool_unref (P2trMeshPool *self);
+
+/** @} */
+#endif
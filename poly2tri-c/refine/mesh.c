@@ -34,6 +34,8 @@
 #include "rutils.h"
 
 #include "mesh.h"
+#include "mesh-index.h"
+#include "mesh-pool.h"
 #include "point.h"
 #include "edge.h"
 #include "triangle.h"
@@ -45,9 +47,14 @@ p2tr_mesh_new (void)
   P2trMesh *mesh = g_slice_new (P2trMesh);
 
   mesh->refcount = 1;
-  mesh->edges = p2tr_hash_set_new_default ();
-  mesh->points = p2tr_hash_set_new_default ();
-  mesh->triangles = p2tr_hash_set_new_default ();
+  mesh->edges = p2tr_dense_set_new ();
+  mesh->points = p2tr_dense_set_new ();
+  mesh->triangles = p2tr_dense_set_new ();
+  mesh->index = NULL;
+
+  mesh->point_pool = p2tr_mesh_pool_new (sizeof (P2trPoint));
+  mesh->edge_pool = p2tr_mesh_pool_new (2 * sizeof (P2trEdge));
+  mesh->triangle_pool = p2tr_mesh_pool_new (sizeof (P2trTriangle));
 
   mesh->record_undo = FALSE;
   g_queue_init (&mesh->undo);
@@ -62,7 +69,7 @@ p2tr_mesh_add_point (P2trMesh  *self,
   g_assert (point->mesh == NULL);
   point->mesh = self;
   p2tr_mesh_ref (self);
-  p2tr_hash_set_insert (self->points, point);
+  point->handle = p2tr_dense_set_insert (self->points, point);
 
   if (self->record_undo)
     g_queue_push_tail (&self->undo, p2tr_mesh_action_new_point (point));
@@ -82,15 +89,16 @@ p2tr_mesh_new_point2 (P2trMesh *self,
                       gdouble   x,
                       gdouble   y)
 {
-  return p2tr_mesh_add_point (self, p2tr_point_new2 (x, y));
+  return p2tr_mesh_add_point (self,
+      p2tr_point_new_from_pool (self->point_pool, x, y));
 }
 
 P2trEdge*
 p2tr_mesh_add_edge (P2trMesh *self,
                     P2trEdge *edge)
 {
-  p2tr_hash_set_insert (self->edges, p2tr_edge_ref (edge->mirror));
-  p2tr_hash_set_insert (self->edges, p2tr_edge_ref (edge));
+  edge->mirror->handle = p2tr_dense_set_insert (self->edges, p2tr_edge_ref (edge->mirror));
+  edge->handle = p2tr_dense_set_insert (self->edges, p2tr_edge_ref (edge));
 
   if (self->record_undo)
     g_queue_push_tail (&self->undo, p2tr_mesh_action_new_edge (edge));
@@ -104,7 +112,8 @@ p2tr_mesh_new_edge (P2trMesh  *self,
                     P2trPoint *end,
                     gboolean   constrained)
 {
-  return p2tr_mesh_add_edge (self, p2tr_edge_new (start, end, constrained));
+  return p2tr_mesh_add_edge (self,
+      p2tr_edge_new_from_pool (self->edge_pool, start, end, constrained));
 }
 
 P2trEdge*
@@ -125,7 +134,19 @@ P2trTriangle*
 p2tr_mesh_add_triangle (P2trMesh     *self,
                         P2trTriangle *tri)
 {
-  p2tr_hash_set_insert (self->triangles, tri);
+  tri->handle = p2tr_dense_set_insert (self->triangles, tri);
+
+  if (self->index != NULL)
+    {
+      /* Build the index again once it is too crowded for the mesh */
+      if (p2tr_mesh_index_is_full (self->index))
+        {
+          p2tr_mesh_index_free (self->index);
+          self->index = p2tr_mesh_index_new (self);
+        }
+      else
+        p2tr_mesh_index_add (self->index, tri);
+    }
 
   if (self->record_undo)
     g_queue_push_tail (&self->undo, p2tr_mesh_action_new_triangle (tri));
@@ -139,7 +160,8 @@ p2tr_mesh_new_triangle (P2trMesh *self,
                         P2trEdge *BC,
                         P2trEdge *CA)
 {
-  return p2tr_mesh_add_triangle (self, p2tr_triangle_new (AB, BC, CA));
+  return p2tr_mesh_add_triangle (self,
+      p2tr_triangle_new_from_pool (self->triangle_pool, AB, BC, CA));
 }
 
 void
@@ -152,7 +174,8 @@ p2tr_mesh_on_point_removed (P2trMesh  *self,
   point->mesh = NULL;
   p2tr_mesh_unref (self);
 
-  p2tr_hash_set_remove (self->points, point);
+  p2tr_dense_set_remove (self->points, point->handle);
+  point->handle = P2TR_DENSE_SET_NO_HANDLE;
 
   if (self->record_undo)
     g_queue_push_tail (&self->undo, p2tr_mesh_action_del_point (point));
@@ -164,9 +187,11 @@ void
 p2tr_mesh_on_edge_removed (P2trMesh *self,
                            P2trEdge *edge)
 {
-  p2tr_hash_set_remove (self->edges, edge->mirror);
+  p2tr_dense_set_remove (self->edges, edge->mirror->handle);
+  edge->mirror->handle = P2TR_DENSE_SET_NO_HANDLE;
   p2tr_edge_unref (edge->mirror);
-  p2tr_hash_set_remove (self->edges, edge);
+  p2tr_dense_set_remove (self->edges, edge->handle);
+  edge->handle = P2TR_DENSE_SET_NO_HANDLE;
 
   if (self->record_undo)
     g_queue_push_tail (&self->undo, p2tr_mesh_action_del_edge (edge));
@@ -178,7 +203,11 @@ void
 p2tr_mesh_on_triangle_removed (P2trMesh     *self,
                                P2trTriangle *triangle)
 {
-  p2tr_hash_set_remove (self->triangles, triangle);
+  if (self->index != NULL)
+    p2tr_mesh_index_remove (self->index, triangle);
+
+  p2tr_dense_set_remove (self->triangles, triangle->handle);
+  triangle->handle = P2TR_DENSE_SET_NO_HANDLE;
 
   if (self->record_undo)
     g_queue_push_tail (&self->undo, p2tr_mesh_action_del_triangle (triangle));
@@ -226,51 +255,139 @@ p2tr_mesh_action_group_undo (P2trMesh *self)
   g_queue_clear (&self->undo);
 }
 
-void
-p2tr_mesh_clear (P2trMesh *self)
+/* Remove the elements one by one, so that each removal is recorded */
+static void
+p2tr_mesh_remove_all_recorded (P2trMesh *self)
 {
-  P2trHashSetIter iter;
+  P2trDenseSetIter iter;
   gpointer temp;
 
-  /* While iterating over the sets of points/edges/triangles to remove
-   * all the mesh elements, the sets will be modified by the removal
-   * operation itself. Therefore we can't use a regular iterator -
-   * instead we must look always at the first place */
-  p2tr_hash_set_iter_init (&iter, self->triangles);
-  while (p2tr_hash_set_iter_next (&iter, &temp))
-    {
-      p2tr_triangle_remove ((P2trTriangle*)temp);
-      p2tr_hash_set_iter_init (&iter, self->triangles);
-    }
+  /* Removing an element only empties its own slot (and the slot of the
+   * mirror of an edge), so the sets can be modified while iterating */
+  p2tr_dense_set_iter_init (&iter, self->triangles);
+  while (p2tr_dense_set_iter_next (&iter, &temp))
+    p2tr_triangle_remove ((P2trTriangle*)temp);
 
-  p2tr_hash_set_iter_init (&iter, self->edges);
-  while (p2tr_hash_set_iter_next (&iter, &temp))
+  p2tr_dense_set_iter_init (&iter, self->edges);
+  while (p2tr_dense_set_iter_next (&iter, &temp))
     {
       g_assert (((P2trEdge*)temp)->tri == NULL);
       p2tr_edge_remove ((P2trEdge*)temp);
-      p2tr_hash_set_iter_init (&iter, self->edges);
     }
 
-  p2tr_hash_set_iter_init (&iter, self->points);
-  while (p2tr_hash_set_iter_next (&iter, &temp))
+  p2tr_dense_set_iter_init (&iter, self->points);
+  while (p2tr_dense_set_iter_next (&iter, &temp))
     {
       g_assert (((P2trPoint*)temp)->outgoing_edges == NULL);
       p2tr_point_remove ((P2trPoint*)temp);
-      p2tr_hash_set_iter_init (&iter, self->points);
     }
 }
 
+/* Drop all the elements in one pass over each set. Since all of them go
+ * away together, nothing is unlinked from its neighbors - only the
+ * references between the elements are released, and the lists of
+ * outgoing edges are freed as a whole */
+static void
+p2tr_mesh_drop_all (P2trMesh *self)
+{
+  GPtrArray *elements;
+  guint i, j;
+
+  /* Each triangle is referenced by the mesh and by its 3 edges, and
+   * holds a reference to each of the edges */
+  elements = self->triangles->elements;
+  for (i = 0; i < elements->len; i++)
+    {
+      P2trTriangle *tri = (P2trTriangle*) g_ptr_array_index (elements, i);
+      if (tri == NULL)
+        continue;
+
+      tri->handle = P2TR_DENSE_SET_NO_HANDLE;
+      for (j = 0; j < 3; j++)
+        {
+          tri->edges[j]->tri = NULL;
+          p2tr_edge_unref (tri->edges[j]);
+          tri->edges[j] = NULL;
+          p2tr_triangle_unref (tri);
+        }
+      p2tr_triangle_unref (tri);
+    }
+
+  /* Each half of an edge is referenced by the mesh and by the list of
+   * outgoing edges of its start point, and holds a reference to its end
+   * point. The pair is freed once both halves are released */
+  elements = self->edges->elements;
+  for (i = 0; i < elements->len; i++)
+    {
+      P2trEdge  *edge = (P2trEdge*) g_ptr_array_index (elements, i);
+      P2trPoint *end;
+      if (edge == NULL)
+        continue;
+
+      end = edge->end;
+      edge->handle = P2TR_DENSE_SET_NO_HANDLE;
+      edge->end = NULL;
+      p2tr_point_unref (end);
+      p2tr_edge_unref (edge);
+      p2tr_edge_unref (edge);
+    }
+
+  /* Each point is referenced by the mesh, and holds a reference to it */
+  elements = self->points->elements;
+  for (i = 0; i < elements->len; i++)
+    {
+      P2trPoint *pt = (P2trPoint*) g_ptr_array_index (elements, i);
+      if (pt == NULL)
+        continue;
+
+      g_list_free (pt->outgoing_edges);
+      pt->outgoing_edges = NULL;
+      pt->handle = P2TR_DENSE_SET_NO_HANDLE;
+      pt->mesh = NULL;
+      p2tr_mesh_unref (self);
+      p2tr_point_unref (pt);
+    }
+}
+
+void
+p2tr_mesh_clear (P2trMesh *self)
+{
+  gboolean use_index = self->index != NULL;
+
+  /* Dropping the index at once is faster than removing each triangle */
+  p2tr_mesh_set_index (self, FALSE);
+
+  if (self->record_undo)
+    p2tr_mesh_remove_all_recorded (self);
+  else
+    p2tr_mesh_drop_all (self);
+
+  /* Forget the free slots, so that the next elements get handles from 0 */
+  p2tr_dense_set_remove_all (self->triangles);
+  p2tr_dense_set_remove_all (self->edges);
+  p2tr_dense_set_remove_all (self->points);
+
+  p2tr_mesh_set_index (self, use_index);
+}
+
 void
 p2tr_mesh_free (P2trMesh *self)
 {
   if (self->record_undo)
     p2tr_mesh_action_group_commit (self);
 
+  p2tr_mesh_set_index (self, FALSE);
   p2tr_mesh_clear (self);
 
-  p2tr_hash_set_free (self->points);
-  p2tr_hash_set_free (self->edges);
-  p2tr_hash_set_free (self->triangles);
+  p2tr_dense_set_free (self->points);
+  p2tr_dense_set_free (self->edges);
+  p2tr_dense_set_free (self->triangles);
+
+  /* The memory of the elements is released as a whole once the last of
+   * them is freed, which is now unless some are still referenced */
+  p2tr_mesh_pool_unref (self->point_pool);
+  p2tr_mesh_pool_unref (self->edge_pool);
+  p2tr_mesh_pool_unref (self->triangle_pool);
 
   g_slice_free (P2trMesh, self);
 }
@@ -290,6 +407,19 @@ p2tr_mesh_ref (P2trMesh *self)
   return self;
 }
 
+void
+p2tr_mesh_set_index (P2trMesh *self,
+                     gboolean  use_index)
+{
+  if (use_index && self->index == NULL)
+    self->index = p2tr_mesh_index_new (self);
+  else if (! use_index && self->index != NULL)
+    {
+      p2tr_mesh_index_free (self->index);
+      self->index = NULL;
+    }
+}
+
 P2trTriangle*
 p2tr_mesh_find_point (P2trMesh *self,
                       const P2trVector2 *pt)
@@ -304,11 +434,17 @@ p2tr_mesh_find_point2 (P2trMesh          *self,
                        gdouble           *u,
                        gdouble           *v)
 {
-  P2trHashSetIter iter;
+  P2trDenseSetIter iter;
   P2trTriangle *result;
-  
-  p2tr_hash_set_iter_init (&iter, self->triangles);
-  while (p2tr_hash_set_iter_next (&iter, (gpointer*)&result))
+
+  if (self->index != NULL)
+    {
+      result = p2tr_mesh_index_find (self->index, pt, u, v);
+      return (result != NULL) ? p2tr_triangle_ref (result) : NULL;
+    }
+
+  p2tr_dense_set_iter_init (&iter, self->triangles);
+  while (p2tr_dense_set_iter_next (&iter, (gpointer*)&result))
     if (p2tr_triangle_contains_point2 (result, pt, u, v) != P2TR_INTRIANGLE_OUT)
       return p2tr_triangle_ref (result);
 
@@ -331,50 +467,61 @@ p2tr_mesh_find_point_local2 (P2trMesh          *self,
                              gdouble           *u,
                              gdouble           *v)
 {
-  P2trHashSet *checked_tris;
-  GQueue to_check;
-  P2trTriangle *result = NULL;
+  P2trTriangle *tri = initial_guess, *prev = NULL;
+  guint max_steps, steps, seed = 1;
 
   if (initial_guess == NULL)
     return p2tr_mesh_find_point2(self, pt, u, v);
 
-  checked_tris = p2tr_hash_set_new_default ();
-  g_queue_init (&to_check);
-  g_queue_push_head (&to_check, initial_guess);
-
-  while (! g_queue_is_empty (&to_check))
+  /* A remembering stochastic walk: cross any edge which has the point on
+   * its outer side, except for the edge we just came through, starting
+   * the checks from a pseudo-random edge of each triangle so that the
+   * walk can't cycle. On a Delaunay mesh it ends after a number of steps
+   * proportional to the length of the walked line */
+  max_steps = p2tr_dense_set_size (self->triangles);
+  for (steps = 0; steps <= max_steps; steps++)
     {
-      P2trTriangle *tri = (P2trTriangle*) g_queue_pop_head (&to_check);
-      
-      p2tr_hash_set_insert (checked_tris, tri);
-      if (p2tr_triangle_contains_point2 (tri, pt, u, v) != P2TR_INTRIANGLE_OUT)
-        {
-          result = tri;
-          break;
-        }
-      else
+      P2trTriangle *next = NULL;
+      gint i, k;
+
+      seed = seed * 1103515245 + 12345;
+      k = (seed >> 16) % 3;
+
+      for (i = 0; i < 3; i++, k = (k + 1) % 3)
         {
-          gint i;
-          for (i = 0; i < 3; i++)
+          P2trEdge *e = tri->edges[k];
+          P2trTriangle *neighbor = e->mirror->tri;
+
+          if (neighbor != NULL && neighbor == prev)
+            continue;
+
+          /* The triangles are clockwise, so the outer side of each edge
+           * is on its left */
+          if (p2tr_math_orient2d (&P2TR_EDGE_START(e)->c, &e->end->c, pt) == P2TR_ORIENTATION_CCW)
             {
-              P2trTriangle *new_to_check = tri->edges[i]->mirror->tri;
-              if (new_to_check != NULL
-                  && ! p2tr_hash_set_contains (checked_tris, new_to_check))
-                {
-                  p2tr_hash_set_insert (checked_tris, new_to_check);
-                  g_queue_push_tail (&to_check, new_to_check);
-                }
+              next = neighbor;
+              break;
             }
         }
-    }
 
-  p2tr_hash_set_free (checked_tris);
-  g_queue_clear (&to_check);
+      if (i == 3)
+        {
+          /* No edge separates the triangle from the point */
+          if (p2tr_triangle_contains_point2 (tri, pt, u, v) != P2TR_INTRIANGLE_OUT)
+            return p2tr_triangle_ref (tri);
+          break;
+        }
 
-  if (result != NULL)
-    p2tr_triangle_ref (result);
+      /* We reached the boundary of the domain - the point may still be
+       * inside it, behind a hole or a concave part of the outline */
+      if (next == NULL)
+        break;
 
-  return result;
+      prev = tri;
+      tri = next;
+    }
+
+  return p2tr_mesh_find_point2 (self, pt, u, v);
 }
 
 void
@@ -387,11 +534,11 @@ p2tr_mesh_get_bounds (P2trMesh    *self,
   gdouble lmin_x = + G_MAXDOUBLE, lmin_y = + G_MAXDOUBLE;
   gdouble lmax_x = - G_MAXDOUBLE, lmax_y = - G_MAXDOUBLE;
 
-  P2trHashSetIter iter;
+  P2trDenseSetIter iter;
   P2trPoint *pt;
 
-  p2tr_hash_set_iter_init (&iter, self->points);
-  while (p2tr_hash_set_iter_next (&iter, (gpointer*) &pt))
+  p2tr_dense_set_iter_init (&iter, self->points);
+  while (p2tr_dense_set_iter_next (&iter, (gpointer*) &pt))
     {
       gdouble x = pt->c.x;
       gdouble y = pt->c.y;
@@ -411,8 +558,8 @@ void
 p2tr_mesh_save_to_file (P2trMesh *self,
                         FILE     *out)
 {
-  guint point_count        = p2tr_hash_set_size (self->points);
-  guint triangle_count     = p2tr_hash_set_size (self->triangles);
+  guint point_count        = p2tr_dense_set_size (self->points);
+  guint triangle_count     = p2tr_dense_set_size (self->triangles);
   guint edge_count_unused  = 0;
 
   P2trPoint    *pt;
@@ -420,52 +567,34 @@ p2tr_mesh_save_to_file (P2trMesh *self,
   gfloat        z_value    = 0;
 
   guint        pt_index;
-  GHashTable  *point2index;
   guint       *indexes;
-  P2trHashSetIter siter;
+  P2trDenseSetIter siter;
 
   /* Begin with the file header */
   fprintf (out, "OFF %u %u %u\n", point_count, triangle_count,
       edge_count_unused);
 
-  /* We would like point2index to maintain a mapping from a point to
-   * it's index in the file. However, we can't do this directly since
-   * a GHashTable stores gpointer values and we have no gaurantee that
-   * sizeof(guint) <= sizeof(gpointer). It is probably true in most
-   * architectures, but relying on it may cause some exotic bugs in
-   * architectures that do not satisfy this condition...
-   * So, we'll create an array of running indexes and then we'll store
-   * a reference to the index in the array.
-   */
-  indexes = g_new (guint, point_count);
-  point2index = g_hash_table_new (g_direct_hash, g_int_equal);
+  /* The handles of the points may have gaps (the slots of removed
+   * points), so map each handle to the running index of the point in
+   * the file */
+  indexes = g_new (guint, p2tr_dense_set_capacity (self->points));
 
   /* Now add a line for each point */
   pt_index = 0;
-  p2tr_hash_set_iter_init (&siter, self->points);
-  while (p2tr_hash_set_iter_next (&siter, (gpointer*)&pt))
+  p2tr_dense_set_iter_init (&siter, self->points);
+  while (p2tr_dense_set_iter_next (&siter, (gpointer*)&pt))
     {
-      indexes[pt_index] = pt_index;
-      g_hash_table_insert (point2index, pt, &indexes[pt_index]);
+      indexes[pt->handle] = pt_index++;
       fprintf (out, "%f %f %f\n", pt->c.x, pt->c.y, z_value);
-      pt_index++;
     }
 
-  p2tr_hash_set_iter_init (&siter, self->triangles);
-  while (p2tr_hash_set_iter_next (&siter, (gpointer*)&tr))
-    {
-      guint* pt_indexes[3];
-      for (pt_index = 0; pt_index < 3; ++pt_index)
-        {
-          pt = P2TR_TRIANGLE_GET_POINT (tr, pt_index);
-          pt_indexes[pt_index] = g_hash_table_lookup (point2index, pt);
-        }
-
-      fprintf (out, "%u %u %u %u\n", 3,
-          *pt_indexes[0],*pt_indexes[1],  *pt_indexes[2]);
-    }
+  p2tr_dense_set_iter_init (&siter, self->triangles);
+  while (p2tr_dense_set_iter_next (&siter, (gpointer*)&tr))
+    fprintf (out, "%u %u %u %u\n", 3,
+        indexes[P2TR_TRIANGLE_GET_POINT (tr, 0)->handle],
+        indexes[P2TR_TRIANGLE_GET_POINT (tr, 1)->handle],
+        indexes[P2TR_TRIANGLE_GET_POINT (tr, 2)->handle]);
 
-  g_hash_table_destroy (point2index);
   g_free (indexes);
 }
 
@@ -52,22 +52,38 @@
 struct P2trMesh_
 {
   /**
-   * A hash set containing pointers to all the triangles
-   * (\ref P2trTriangle) in the mesh
+   * A dense set containing pointers to all the triangles
+   * (\ref P2trTriangle) in the mesh. Each triangle is at the slot
+   * given by its handle
    */
-  P2trHashSet *triangles;
+  P2trDenseSet *triangles;
 
   /**
-   * A hash set containing pointers to all the edges (\ref P2trEdge) in
-   * the mesh
+   * A dense set containing pointers to all the edges (\ref P2trEdge) in
+   * the mesh. An edge and its mirror have separate handles
    */
-  P2trHashSet *edges;
+  P2trDenseSet *edges;
 
   /**
-   * A hash set containing pointers to all the points (\ref P2trPoint)
+   * A dense set containing pointers to all the points (\ref P2trPoint)
    * in the mesh
    */
-  P2trHashSet *points;
+  P2trDenseSet *points;
+
+  /**
+   * An optional index of the triangles, for finding the triangle
+   * containing a point without a starting triangle. NULL unless enabled
+   * by \ref p2tr_mesh_set_index
+   */
+  P2trMeshIndex *index;
+
+  /**
+   * The pools from which the points, the edges (with their mirrors) and
+   * the triangles created by the mesh are allocated
+   */
+  P2trMeshPool *point_pool;
+  P2trMeshPool *edge_pool;
+  P2trMeshPool *triangle_pool;
 
   /**
    * A boolean flag specifying whether recording of actions on the
@@ -244,7 +260,10 @@ void          p2tr_mesh_action_group_commit   (P2trMesh *self);
 void          p2tr_mesh_action_group_undo     (P2trMesh *self);
 
 /**
- * Remove all triangles, edges and points from a mesh
+ * Remove all triangles, edges and points from a mesh. Unless actions
+ * on the mesh are being recorded, the elements are dropped together in
+ * time linear in their amount, without updating the neighbors of each
+ * removed element on the way
  * @param mesh The mesh to clear
  */
 void          p2tr_mesh_clear           (P2trMesh *mesh);
@@ -268,6 +287,19 @@ void          p2tr_mesh_unref           (P2trMesh *mesh);
  */
 P2trMesh*     p2tr_mesh_ref             (P2trMesh *mesh);
 
+/**
+ * Choose whether the mesh should keep an index of its triangles. The
+ * index is updated whenever a triangle is added or removed, and makes
+ * \ref p2tr_mesh_find_point take expected constant time instead of time
+ * linear in the amount of triangles, at the cost of the memory of the
+ * index and of some work for every added and removed triangle.
+ * By default, there is no index
+ * @param self The mesh whose index should be created or dropped
+ * @param use_index Whether the mesh should have an index
+ */
+void          p2tr_mesh_set_index       (P2trMesh *self,
+                                         gboolean  use_index);
+
 /**
  * Find a triangle of the mesh, containing the point at the given
  * location
@@ -297,23 +329,18 @@ P2trTriangle* p2tr_mesh_find_point2     (P2trMesh          *self,
 
 /**
  * Another variant of \ref p2tr_mesh_find_point taking an initial
- * triangle that the search should begin from its area. The search is
- * performed first on triangles close to the given triangle, and it
- * gradually tests farther and farther triangles until it finds the one
- * containing the given point.
- *
- * This way of search should be fast when the approximate area of the
- * point to find is known, but it will be slower if initial triangle
- * is not near.
+ * triangle that the search should begin from. The search walks from
+ * the given triangle towards the point, from each triangle to the
+ * neighbor across an edge separating it from the point, until it finds
+ * the triangle containing the point.
  *
- * Note that in this function, triangles are considered near depending
- * on the length of the chain of neighbor triangles needed to go from
- * one to the other.
+ * This way of search is fast when the approximate area of the point to
+ * find is known, and it takes time proportional to the amount of
+ * triangles crossed on the way. It allocates no memory.
  *
- * \warning This function may use memory which is at least linear in
- *          the amount of triangles to test. Therefor, do not use it
- *          on large mesh objects unless the initial guess is supposed
- *          to be good!
+ * If the walk reaches the boundary of the domain (the point is outside
+ * of it, or behind a hole or a concave part of the outline), the search
+ * falls back to \ref p2tr_mesh_find_point.
  * @param self The mesh whose triangles should be checked
  * @param pt The location of the point to test
  * @param initial_guess An initial guess for which triangle contains
@@ -34,6 +34,7 @@
 #include "point.h"
 #include "edge.h"
 #include "mesh.h"
+#include "mesh-pool.h"
 
 P2trPoint*
 p2tr_point_new (const P2trVector2 *c)
@@ -44,13 +45,25 @@ p2tr_point_new (const P2trVector2 *c)
 P2trPoint*
 p2tr_point_new2 (gdouble x, gdouble y)
 {
-  P2trPoint *self = g_slice_new (P2trPoint);
+  return p2tr_point_new_from_pool (NULL, x, y);
+}
+
+P2trPoint*
+p2tr_point_new_from_pool (P2trMeshPool *pool,
+                          gdouble       x,
+                          gdouble       y)
+{
+  P2trPoint *self = (pool != NULL)
+      ? (P2trPoint*) p2tr_mesh_pool_alloc (pool)
+      : g_slice_new (P2trPoint);
   
   self->c.x = x;
   self->c.y = y;
   self->mesh = NULL;
   self->outgoing_edges = NULL;
   self->refcount = 1;
+  self->handle = P2TR_DENSE_SET_NO_HANDLE;
+  self->pool = pool;
 
   return self;
 }
@@ -72,7 +85,10 @@ void
 p2tr_point_free (P2trPoint *self)
 {
   p2tr_point_remove (self);
-  g_slice_free (P2trPoint, self);
+  if (self->pool != NULL)
+    p2tr_mesh_pool_free (self->pool, self);
+  else
+    g_slice_free (P2trPoint, self);
 }
 
 P2trEdge*
@@ -54,15 +54,27 @@ struct P2trPoint_
 
   /** A count of references to the point */
   guint        refcount;
+
+  /** The handle of this point in the points of its mesh */
+  guint        handle;
   
   /** The triangular mesh containing this point */
   P2trMesh    *mesh;
+
+  /** The pool this point was allocated from, or NULL */
+  P2trMeshPool *pool;
 };
 
 P2trPoint*  p2tr_point_new                  (const P2trVector2 *c);
 
 P2trPoint*  p2tr_point_new2                 (gdouble x, gdouble y);
 
+/** Like \ref p2tr_point_new2, but allocate the point from the given pool
+ * (or from the slice allocator, if it is NULL) */
+P2trPoint*  p2tr_point_new_from_pool        (P2trMeshPool *pool,
+                                             gdouble       x,
+                                             gdouble       y);
+
 P2trPoint*  p2tr_point_ref                  (P2trPoint *self);
 
 void        p2tr_point_unref                (P2trPoint *self);
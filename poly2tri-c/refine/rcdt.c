@@ -57,17 +57,17 @@ p2tr_cdt_validate_unused (P2trCDT* self)
 {
   P2trEdge *ed;
   P2trTriangle *tri;
-  P2trHashSetIter iter;
+  P2trDenseSetIter iter;
 
-  p2tr_hash_set_iter_init (&iter, self->mesh->edges);
-  while (p2tr_hash_set_iter_next (&iter, (gpointer*)&ed))
+  p2tr_dense_set_iter_init (&iter, self->mesh->edges);
+  while (p2tr_dense_set_iter_next (&iter, (gpointer*)&ed))
     {
       g_assert (ed->mirror != NULL);
       g_assert (! p2tr_edge_is_removed (ed));
     }
 
-  p2tr_hash_set_iter_init (&iter, self->mesh->triangles);
-  while (p2tr_hash_set_iter_next (&iter, (gpointer*)&tri))
+  p2tr_dense_set_iter_init (&iter, self->mesh->triangles);
+  while (p2tr_dense_set_iter_next (&iter, (gpointer*)&tri))
     g_assert (! p2tr_triangle_is_removed (tri));
 }
 
@@ -75,10 +75,12 @@ P2trCDT*
 p2tr_cdt_new (P2tCDT *cdt)
 {
   P2tTrianglePtrArray cdt_tris = p2t_cdt_get_triangles (cdt);
-  GHashTable *point_map = g_hash_table_new (g_direct_hash, g_direct_equal);
+  guint n_points = p2t_cdt_get_point_count (cdt);
+  /* The points of the CDT by their input index, and the input index of
+   * each triangle vertex - this way no point lookups are needed */
+  P2trPoint **point_map = g_new0 (P2trPoint*, n_points);
+  guint32 *indices = g_new (guint32, 3 * cdt_tris->len);
   P2trCDT *rmesh = g_slice_new (P2trCDT);
-  GHashTableIter iter;
-  P2trPoint *pt_iter = NULL;
 
   P2trVEdgeSet *new_edges = p2tr_vedge_set_new ();
 
@@ -87,19 +89,18 @@ p2tr_cdt_new (P2tCDT *cdt)
   rmesh->mesh = p2tr_mesh_new ();
   rmesh->outline = p2tr_pslg_new ();
 
+  p2t_cdt_get_indexed (cdt, NULL, indices);
+
   /* First iteration over the CDT - create all the points */
   for (i = 0; i < cdt_tris->len; i++)
   {
     P2tTriangle *cdt_tri = triangle_index (cdt_tris, i);
     for (j = 0; j < 3; j++)
       {
-        P2tPoint *cdt_pt = p2t_triangle_get_point(cdt_tri, j);
-        P2trPoint *new_pt = (P2trPoint*) g_hash_table_lookup (point_map, cdt_pt);
-
-        if (new_pt == NULL)
+        if (point_map[indices[3 * i + j]] == NULL)
           {
-            new_pt = p2tr_mesh_new_point2 (rmesh->mesh, cdt_pt->x, cdt_pt->y);
-            g_hash_table_insert (point_map, cdt_pt, new_pt);
+            P2tPoint *cdt_pt = p2t_triangle_get_point(cdt_tri, j);
+            point_map[indices[3 * i + j]] = p2tr_mesh_new_point2 (rmesh->mesh, cdt_pt->x, cdt_pt->y);
           }
       }
   }
@@ -116,12 +117,12 @@ p2tr_cdt_new (P2tCDT *cdt)
         P2tPoint *end = p2t_triangle_get_point (cdt_tri, (j + 1) % 3);
         int edge_index = p2t_triangle_edge_index (cdt_tri, start, end);
 
-        P2trPoint *start_new = (P2trPoint*) g_hash_table_lookup (point_map, start);
-        P2trPoint *end_new = (P2trPoint*) g_hash_table_lookup (point_map, end);
+        P2trPoint *start_new = point_map[indices[3 * i + j]];
+        P2trPoint *end_new = point_map[indices[3 * i + (j + 1) % 3]];
 
         if (! p2tr_point_has_edge_to (start_new, end_new))
           {
-            gboolean constrained = cdt_tri->constrained_edge[edge_index]
+            gboolean constrained = p2t_triangle_get_constrained_edge (cdt_tri, edge_index)
             || cdt_tri->neighbors_[edge_index] == NULL;
             P2trEdge *edge = p2tr_mesh_new_edge (rmesh->mesh, start_new, end_new, constrained);
 
@@ -141,11 +142,9 @@ p2tr_cdt_new (P2tCDT *cdt)
   /* Third iteration over the CDT - create all the triangles */
   for (i = 0; i < cdt_tris->len; i++)
   {
-    P2tTriangle *cdt_tri = triangle_index (cdt_tris, i);
-
-    P2trPoint *pt1 = (P2trPoint*) g_hash_table_lookup (point_map, p2t_triangle_get_point (cdt_tri, 0));
-    P2trPoint *pt2 = (P2trPoint*) g_hash_table_lookup (point_map, p2t_triangle_get_point (cdt_tri, 1));
-    P2trPoint *pt3 = (P2trPoint*) g_hash_table_lookup (point_map, p2t_triangle_get_point (cdt_tri, 2));
+    P2trPoint *pt1 = point_map[indices[3 * i]];
+    P2trPoint *pt2 = point_map[indices[3 * i + 1]];
+    P2trPoint *pt3 = point_map[indices[3 * i + 2]];
 
     P2trTriangle *new_tri = p2tr_mesh_new_triangle (rmesh->mesh,
         p2tr_point_get_edge_to(pt1, pt2, FALSE),
@@ -162,10 +161,11 @@ p2tr_cdt_new (P2tCDT *cdt)
   p2tr_vedge_set_free (new_edges);
 
   /* Now finally unref the points we added into the map */
-  g_hash_table_iter_init (&iter, point_map);
-  while (g_hash_table_iter_next (&iter, NULL, (gpointer*)&pt_iter))
-    p2tr_point_unref (pt_iter);
-  g_hash_table_destroy (point_map);
+  for (i = 0; i < n_points; i++)
+    if (point_map[i] != NULL)
+      p2tr_point_unref (point_map[i]);
+  g_free (point_map);
+  g_free (indices);
 
   return rmesh;
 }
@@ -190,11 +190,11 @@ p2tr_cdt_free_full (P2trCDT* self, gboolean clear_mesh)
 void
 p2tr_cdt_validate_edges (P2trCDT *self)
 {
-  P2trHashSetIter iter;
+  P2trDenseSetIter iter;
   P2trEdge *e;
 
-  p2tr_hash_set_iter_init (&iter, self->mesh->edges);
-  while (p2tr_hash_set_iter_next (&iter, (gpointer*)&e))
+  p2tr_dense_set_iter_init (&iter, self->mesh->edges);
+  while (p2tr_dense_set_iter_next (&iter, (gpointer*)&e))
     {
       if (! e->constrained && e->tri == NULL)
         p2tr_exception_geometric ("Found a non constrained edge without a triangle");
@@ -251,12 +251,12 @@ p2tr_cdt_has_empty_circum_circle (P2trCDT      *self,
 {
   P2trCircle circum;
   P2trPoint *p;
-  P2trHashSetIter iter;
+  P2trDenseSetIter iter;
 
   p2tr_triangle_get_circum_circle (tri, &circum);
 
-  p2tr_hash_set_iter_init (&iter, self->mesh->points);
-  while (p2tr_hash_set_iter_next (&iter, (gpointer*)&p))
+  p2tr_dense_set_iter_init (&iter, self->mesh->points);
+  while (p2tr_dense_set_iter_next (&iter, (gpointer*)&p))
     {
       /** TODO: FIXME - is a point on a constrained edge really not a
        * problem?! */
@@ -278,11 +278,11 @@ p2tr_cdt_has_empty_circum_circle (P2trCDT      *self,
 void
 p2tr_cdt_validate_cdt (P2trCDT *self)
 {
-  P2trHashSetIter iter;
+  P2trDenseSetIter iter;
   P2trTriangle *tri;
 
-  p2tr_hash_set_iter_init (&iter, self->mesh->triangles);
-  while (p2tr_hash_set_iter_next (&iter, (gpointer*)&tri))
+  p2tr_dense_set_iter_init (&iter, self->mesh->triangles);
+  while (p2tr_dense_set_iter_next (&iter, (gpointer*)&tri))
     if (! p2tr_cdt_has_empty_circum_circle(self, tri))
       p2tr_exception_geometric ("Not a CDT!");
 }
@@ -48,6 +48,8 @@
 #include "edge.h"
 #include "triangle.h"
 #include "mesh.h"
+#include "mesh-index.h"
+#include "mesh-pool.h"
 
 #include "vedge.h"
 #include "vtriangle.h"
@@ -32,6 +32,7 @@
 
 #include <math.h>
 #include <glib.h>
+#include <poly2tri-c/p2t/common/predicates.h>
 #include "rmath.h"
 
 gdouble
@@ -66,27 +67,6 @@ p2tr_matrix_det3 (gdouble a00, gdouble a01, gdouble a02,
         + a02 * (a10 * a21 - a20 * a11);
 }
 
-static inline gdouble
-p2tr_matrix_det4 (gdouble a00, gdouble a01, gdouble a02, gdouble a03,
-                  gdouble a10, gdouble a11, gdouble a12, gdouble a13,
-                  gdouble a20, gdouble a21, gdouble a22, gdouble a23,
-                  gdouble a30, gdouble a31, gdouble a32, gdouble a33)
-{
-    return
-        + a00 * p2tr_matrix_det3 (a11, a12, a13,
-                                 a21, a22, a23,
-                                 a31, a32, a33)
-        - a01 * p2tr_matrix_det3 (a10, a12, a13,
-                                  a20, a22, a23,
-                                  a30, a32, a33)
-        + a02 * p2tr_matrix_det3 (a10, a11, a13,
-                                  a20, a21, a23,
-                                  a30, a31, a33)
-        - a03 * p2tr_matrix_det3 (a10, a11, a12,
-                                  a20, a21, a22,
-                                  a30, a31, a32);
-}
-
 void
 p2tr_math_triangle_circumcircle (const P2trVector2 *A,
                                  const P2trVector2 *B,
@@ -209,12 +189,11 @@ P2trOrientation p2tr_math_orient2d (const P2trVector2 *A,
    * |Ax Ay 1|
    * |Bx By 1|
    * |Cx Cy 1|
+   * The predicate gets the sign right even when the rounding errors are
+   * larger than the result. The epsilon still decides which (almost)
+   * collinear points are treated as lying on a line
    */
-  gdouble result = p2tr_matrix_det3 (
-      A->x, A->y, 1,
-      B->x, B->y, 1,
-      C->x, C->y, 1
-  );
+  gdouble result = p2t_predicates_orient2d (A->x, A->y, B->x, B->y, C->x, C->y);
 
   if (result > ORIENT2D_EPSILON)
     return P2TR_ORIENTATION_CCW;
@@ -239,16 +218,12 @@ p2tr_math_incircle (const P2trVector2 *A,
    * |Cx Cy Cx^2+Cy^2 1|
    * |Dx Dy Dx^2+Dy^2 1|
    */
-  gdouble result = p2tr_matrix_det4 (
-      A->x, A->y, P2TR_VECTOR2_LEN_SQ(A), 1,
-      B->x, B->y, P2TR_VECTOR2_LEN_SQ(B), 1,
-      C->x, C->y, P2TR_VECTOR2_LEN_SQ(C), 1,
-      D->x, D->y, P2TR_VECTOR2_LEN_SQ(D), 1
-  );
+  gdouble result = p2t_predicates_incircle (A->x, A->y, B->x, B->y,
+                                            C->x, C->y, D->x, D->y);
 
   if (result > INCIRCLE_EPSILON)
     return P2TR_INCIRCLE_IN;
-  else if (result < INCIRCLE_EPSILON)
+  else if (result < -INCIRCLE_EPSILON)
     return P2TR_INCIRCLE_OUT;
   else
     return P2TR_INCIRCLE_ON;
@@ -49,3 +49,80 @@ p2tr_utils_new_reversed_pointer_list (int count, ...)
   
   return result;
 }
+
+P2trDenseSet*
+p2tr_dense_set_new (void)
+{
+  P2trDenseSet *set = g_slice_new (P2trDenseSet);
+  set->elements = g_ptr_array_new ();
+  set->free_slots = g_array_new (FALSE, FALSE, sizeof (guint));
+  return set;
+}
+
+void
+p2tr_dense_set_free (P2trDenseSet *set)
+{
+  g_ptr_array_free (set->elements, TRUE);
+  g_array_free (set->free_slots, TRUE);
+  g_slice_free (P2trDenseSet, set);
+}
+
+guint
+p2tr_dense_set_insert (P2trDenseSet *set,
+                       gpointer      element)
+{
+  guint handle;
+
+  g_assert (element != NULL);
+
+  if (set->free_slots->len > 0)
+    {
+      handle = g_array_index (set->free_slots, guint, set->free_slots->len - 1);
+      g_array_set_size (set->free_slots, set->free_slots->len - 1);
+      g_ptr_array_index (set->elements, handle) = element;
+    }
+  else
+    {
+      handle = set->elements->len;
+      g_ptr_array_add (set->elements, element);
+    }
+
+  return handle;
+}
+
+void
+p2tr_dense_set_remove (P2trDenseSet *set,
+                       guint         handle)
+{
+  g_assert (handle < set->elements->len);
+  g_assert (g_ptr_array_index (set->elements, handle) != NULL);
+
+  g_ptr_array_index (set->elements, handle) = NULL;
+  g_array_append_val (set->free_slots, handle);
+}
+
+void
+p2tr_dense_set_remove_all (P2trDenseSet *set)
+{
+  g_ptr_array_set_size (set->elements, 0);
+  g_array_set_size (set->free_slots, 0);
+}
+
+gboolean
+p2tr_dense_set_iter_next (P2trDenseSetIter *iter,
+                          gpointer         *val)
+{
+  GPtrArray *elements = iter->set->elements;
+
+  while (iter->next < elements->len)
+    {
+      gpointer element = g_ptr_array_index (elements, iter->next++);
+      if (element != NULL)
+        {
+          *val = element;
+          return TRUE;
+        }
+    }
+
+  return FALSE;
+}
@@ -70,6 +70,48 @@ G_STMT_END
 #define p2tr_hash_set_iter_next(iter,val) g_hash_table_iter_next ((iter),(val),NULL)
 #define p2tr_hash_set_iter_remove(iter) g_hash_table_iter_remove ((iter))
 
+  /* A set of pointers kept in one dense array. Each element gets an
+   * integer handle - its slot in the array - which stays the same as
+   * long as the element is in the set. The slots of removed elements are
+   * set to NULL and kept in a free list, to be reused by the next added
+   * elements, so adding and removing take constant time without any
+   * hashing, and iterating goes over the array in order.
+   * The set does not remember the handles of its elements, so whoever
+   * adds an element must keep its handle for removing it later.
+   */
+  typedef struct
+  {
+    /* The elements, with NULL at the free slots */
+    GPtrArray *elements;
+    /* The handles of the free slots (guint) */
+    GArray    *free_slots;
+  } P2trDenseSet;
+
+  typedef struct
+  {
+    P2trDenseSet *set;
+    guint         next;
+  } P2trDenseSetIter;
+
+/* A handle which is never given to an element */
+#define P2TR_DENSE_SET_NO_HANDLE G_MAXUINT
+
+P2trDenseSet* p2tr_dense_set_new        (void);
+void          p2tr_dense_set_free       (P2trDenseSet *set);
+guint         p2tr_dense_set_insert     (P2trDenseSet *set, gpointer element);
+void          p2tr_dense_set_remove     (P2trDenseSet *set, guint handle);
+void          p2tr_dense_set_remove_all (P2trDenseSet *set);
+
+#define p2tr_dense_set_get(set,handle) g_ptr_array_index ((set)->elements, (handle))
+#define p2tr_dense_set_contains(set,handle,element)                \
+  ((handle) < (set)->elements->len && p2tr_dense_set_get ((set), (handle)) == (element))
+#define p2tr_dense_set_size(set) ((set)->elements->len - (set)->free_slots->len)
+/* The amount of slots, which is greater than any handle in the set */
+#define p2tr_dense_set_capacity(set) ((set)->elements->len)
+
+#define p2tr_dense_set_iter_init(iter,dense_set) G_STMT_START { (iter)->set = (dense_set); (iter)->next = 0; } G_STMT_END
+gboolean      p2tr_dense_set_iter_next  (P2trDenseSetIter *iter, gpointer *val);
+
 #define g_list_cyclic_prev(list,elem) (((elem)->prev != NULL) ? (elem)->prev : g_list_last ((elem)))
 #define g_list_cyclic_next(list,elem) (((elem)->next != NULL) ? (elem)->next : g_list_first ((elem)))
 
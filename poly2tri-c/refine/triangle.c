@@ -40,6 +40,7 @@
 #include "edge.h"
 #include "triangle.h"
 #include "mesh.h"
+#include "mesh-pool.h"
 
 void
 p2tr_validate_edges_can_form_tri (P2trEdge *AB,
@@ -70,11 +71,24 @@ P2trTriangle*
 p2tr_triangle_new (P2trEdge *AB,
                    P2trEdge *BC,
                    P2trEdge *CA)
+{
+  return p2tr_triangle_new_from_pool (NULL, AB, BC, CA);
+}
+
+P2trTriangle*
+p2tr_triangle_new_from_pool (P2trMeshPool *pool,
+                             P2trEdge     *AB,
+                             P2trEdge     *BC,
+                             P2trEdge     *CA)
 {
   gint i;
-  P2trTriangle *self = g_slice_new (P2trTriangle);
+  P2trTriangle *self = (pool != NULL)
+      ? (P2trTriangle*) p2tr_mesh_pool_alloc (pool)
+      : g_slice_new (P2trTriangle);
 
   self->refcount = 0;
+  self->handle = P2TR_DENSE_SET_NO_HANDLE;
+  self->pool = pool;
 
 #ifndef P2TC_NO_LOGIC_CHECKS
   p2tr_validate_edges_can_form_tri (AB, BC, CA);
@@ -143,7 +157,10 @@ void
 p2tr_triangle_free (P2trTriangle *self)
 {
   g_assert (p2tr_triangle_is_removed (self));
-  g_slice_free (P2trTriangle, self);
+  if (self->pool != NULL)
+    p2tr_mesh_pool_free (self->pool, self);
+  else
+    g_slice_free (P2trTriangle, self);
 }
 
 void
@@ -46,12 +46,25 @@ struct P2trTriangle_
   P2trEdge* edges[3];
   
   guint refcount;
+
+  /** The handle of this triangle in the triangles of its mesh */
+  guint handle;
+
+  /** The pool this triangle was allocated from, or NULL */
+  P2trMeshPool *pool;
 };
 
 P2trTriangle*   p2tr_triangle_new            (P2trEdge *AB,
                                               P2trEdge *BC,
                                               P2trEdge *CA);
 
+/** Like \ref p2tr_triangle_new, but allocate the triangle from the given
+ * pool (or from the slice allocator, if it is NULL) */
+P2trTriangle*   p2tr_triangle_new_from_pool  (P2trMeshPool *pool,
+                                              P2trEdge     *AB,
+                                              P2trEdge     *BC,
+                                              P2trEdge     *CA);
+
 P2trTriangle* p2tr_triangle_ref              (P2trTriangle *self);
 
 void        p2tr_triangle_unref              (P2trTriangle *self);
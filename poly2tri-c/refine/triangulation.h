@@ -41,6 +41,10 @@ typedef struct P2trEdge_      P2trEdge;
 typedef struct P2trTriangle_  P2trTriangle;
 /** \ingroup P2trMesh */
 typedef struct P2trMesh_      P2trMesh;
+/** \ingroup P2trMeshIndex */
+typedef struct P2trMeshIndex_ P2trMeshIndex;
+/** \ingroup P2trMeshPool */
+typedef struct P2trMeshPool_  P2trMeshPool;
 
 /** \ingroup P2trVEdge */
 typedef struct P2trVEdge_     P2trVEdge;
@@ -80,7 +80,13 @@ p2tr_mesh_render_cache_uvt_exact (P2trMesh        *T,
   P2trUVT *uvt = dest;
   P2trTriangle *tr_prev = NULL;
   P2trVector2 pt;
-  
+  gboolean had_index = T->index != NULL;
+
+  /* The first point, and every point following one outside of the
+   * domain, are located without a starting triangle - which is fast
+   * only when the mesh has an index */
+  p2tr_mesh_set_index (T, TRUE);
+
   pt.x = config->min_x;
   pt.y = config->min_y;
 
@@ -88,17 +94,18 @@ p2tr_mesh_render_cache_uvt_exact (P2trMesh        *T,
   if (uvt->tri) p2tr_triangle_unref (uvt->tri);
   tr_prev = uvt->tri;
   
-  for (y = 0, pt.y = config->min_y; y < config->y_samples; ++y, pt.y += config->step_y)
+  for (y = 0, pt.y = config->min_y; y < config->y_samples && n > 0; ++y, pt.y += config->step_y)
     {
-      for (x = 0, pt.x = config->min_x; x < config->x_samples; ++x, pt.x += config->step_x)
+      for (x = 0, pt.x = config->min_x; x < config->x_samples && n > 0; ++x, pt.x += config->step_x, --n)
         {
-          if (n-- == 0) return;
           uvt->tri = p2tr_mesh_find_point_local2 (T, &pt, tr_prev, &uvt->u, &uvt->v);
           if (uvt->tri) p2tr_triangle_unref (uvt->tri);
           tr_prev = uvt->tri;
           ++uvt;
         }
     }
+
+  p2tr_mesh_set_index (T, had_index);
 }
 
 #define P2TR_USE_BARYCENTRIC(u, v, A, B, C)                            \
@@ -150,7 +150,7 @@ void
 p2tr_render_svg (P2trMesh *mesh,
                  FILE     *out)
 {
-  P2trHashSetIter  siter;
+  P2trDenseSetIter siter;
   P2trTriangle    *tr;
   P2trPoint       *pt;
 
@@ -189,15 +189,15 @@ p2tr_render_svg (P2trMesh *mesh,
   top_right.y += 10;
   p2tr_render_svg_init (out, &bottom_left, &top_right);
 
-  p2tr_hash_set_iter_init (&siter, mesh->triangles);
-  while (p2tr_hash_set_iter_next (&siter, (gpointer*)&tr))
+  p2tr_dense_set_iter_init (&siter, mesh->triangles);
+  while (p2tr_dense_set_iter_next (&siter, (gpointer*)&tr))
     p2tr_render_svg_draw_triangle (out, &TRI,
         &P2TR_TRIANGLE_GET_POINT(tr, 0)->c,
         &P2TR_TRIANGLE_GET_POINT(tr, 1)->c,
         &P2TR_TRIANGLE_GET_POINT(tr, 2)->c);
 
-  p2tr_hash_set_iter_init (&siter, mesh->points);
-  while (p2tr_hash_set_iter_next (&siter, (gpointer*)&pt))
+  p2tr_dense_set_iter_init (&siter, mesh->points);
+  while (p2tr_dense_set_iter_next (&siter, (gpointer*)&pt))
     p2tr_render_svg_draw_circle (out, &PT, &pt->c, 1);
 
   p2tr_render_svg_finish (out);